@@ -82,6 +82,50 @@ function getVisibleItems(container, relativeTo, cond) {
   return v;
 }
 
+// Tells the model of a ListView or GridView which of its items are visible, and
+// which way the view scrolls, so the model can prefetch what comes next. The
+// model is only told when the visible items or their count changed since the
+// previous report. Returns what was reported, to pass as previous next time.
+function reportVisibleRange(view, horizontal, previous) {
+  var position = horizontal ? view.contentX : view.contentY;
+  if (!view.model || !view.model.setVisibleRange || view.count === 0)
+    return { position: position, first: -1, last: -1, count: 0 };
+
+  // The corners can fall between items, or on a header or footer; they are
+  // then looked up again further in by the spacing, and failing that the
+  // other end is used
+  var inset = Math.max(view.spacing || 0, 0) + 1;
+  var right = view.contentX + view.width - 1;
+  var bottom = view.contentY + view.height - 1;
+  var first = view.indexAt(view.contentX + 1, view.contentY + 1);
+  if (first < 0)
+    first = view.indexAt(view.contentX + inset, view.contentY + inset);
+  var last = view.indexAt(right, bottom);
+  if (last < 0)
+    last = view.indexAt(right - inset, bottom - inset);
+
+  if (first < 0 && last < 0)
+    return previous ? previous : { position: position, first: -1, last: -1, count: 0 };
+  if (first < 0)
+    first = last;
+  if (last < 0)
+    last = first;
+
+  if (previous && first === previous.first && last === previous.last &&
+      view.count === previous.count)
+    return previous;
+
+  var direction = 0;
+  if (previous && position > previous.position)
+    direction = 1;
+  else if (previous && position < previous.position)
+    direction = -1;
+
+  view.model.setVisibleRange(first, last, direction);
+
+  return { position: position, first: first, last: last, count: view.count };
+}
+
 function doesPointIntersectRect(x, y, rect) {
   return x >= rect.x && x <= (rect.x + rect.width) && y >= rect.y && y <= (rect.y + rect.height);
 }
@@ -39,13 +39,16 @@ Item {
     property bool load: false
     /// True if the photo is visible, either as preview, or as full version
     property bool isLoaded: preview.status === Image.Ready || fullImage.status === Image.Ready
+    /// Thumbnail of the media, evaluated once for both images
+    readonly property string thumbnailSource: mediaSource ?
+        "image://thumbnailer/" + mediaSource.path + "?at=" + mediaSource.lastModified : ""
 
     Image {
         id: preview
         anchors.fill: parent
         asynchronous: true
         visible: fullImage.opacity < 1
-        source: load && mediaSource ? "image://thumbnailer/" + mediaSource.path + "?at=" + mediaSource.lastModified : ""
+        source: load ? thumbnailSource : ""
         fillMode: fullImage.fillMode
         sourceSize.width: 256
     }
@@ -55,8 +58,7 @@ Item {
         asynchronous: true
         cache: false
         fillMode: Image.PreserveAspectCrop
-        source: (preview.status === Image.Ready && !isPreview) ?
-                "image://thumbnailer/" + mediaSource.path + "?at=" + mediaSource.lastModified : ""
+        source: (preview.status === Image.Ready && !isPreview) ? thumbnailSource : ""
 
         property int maxSize: Math.max(width, height)
         sourceSize.width: maxSize
@@ -41,6 +41,9 @@ GridView {
     property real minimumSpace: units.gu(0.6)
     /// Stores the spacing between 2 images in pixel
     property real spacing: __calculateSpacing(width)
+    /// Range and position last reported to the model, to tell which way the grid
+    /// scrolls and whether the visible items changed
+    property var __reportedRange: null
 
     /*!
     Calculates the spacing that should be used, to fit the fotos horizontally nicely
@@ -88,7 +91,7 @@ GridView {
             sourceFillMode: UbuntuShape.PreserveAspectCrop
             source: Image {
                 id: thumbImage
-                source: "image://thumbnailer/" + mediaSource.path + "?at=" + mediaSource.lastModified
+                source: thumbnailUrl
                 asynchronous: true
                 fillMode: Image.PreserveAspectCrop
                 sourceSize {
@@ -111,7 +114,7 @@ GridView {
                 // Display a play icon if the thumbnail is from a video
                 source: "../../img/icon_play.png"
                 anchors.centerIn: parent
-                visible: mediaSource.type === MediaSource.Video && thumbImage.status == Image.Ready
+                visible: mediaType === MediaSource.Video && thumbImage.status == Image.Ready
             }
 
             OrganicItemInteraction {
@@ -143,6 +146,15 @@ GridView {
         }
     }
 
+    onContentYChanged: __reportVisibleRange()
+    onCountChanged: __reportVisibleRange()
+    onHeightChanged: __reportVisibleRange()
+
+    function __reportVisibleRange() {
+        __reportedRange = GalleryUtility.reportVisibleRange(photosGrid, false,
+                                                            __reportedRange);
+    }
+
     displaced: Transition {
         NumberAnimation {
             properties: "x,y"
@@ -22,6 +22,7 @@
 import QtQuick 2.4
 import Ubuntu.Components 1.3
 import "../Components"
+import "../../js/GalleryUtility.js" as GalleryUtility
 
 // Displays a flickable photo stream.
 //
@@ -34,6 +35,10 @@ ListView {
     */
     property int currentIndexForHighlight: -1
 
+    /// Range and position last reported to the model, to tell which way the view
+    /// scrolls and whether the visible items changed
+    property var __reportedRange: null
+
     // NOTE: These properties should be treated as read-only, as setting them
     // individually can lead to bogus results.  Use setCurrentIndex() to
     // initialize the view.
@@ -66,6 +71,14 @@ ListView {
             currentIndexForHighlight = currentIndex;
     }
 
+    onContentXChanged: __reportVisibleRange()
+    onCountChanged: __reportVisibleRange()
+
+    function __reportVisibleRange() {
+        __reportedRange = GalleryUtility.reportVisibleRange(mediaListView, true,
+                                                            __reportedRange);
+    }
+
     // Keyboard focus while visible
     onVisibleChanged: {
         if (visible)
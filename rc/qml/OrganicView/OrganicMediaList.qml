@@ -177,7 +177,7 @@ Item {
                 sourceFillMode: UbuntuShape.PreserveAspectCrop
                 source: Image {
                     id: thumbImage
-                    source: "image://thumbnailer/" + model.mediaSource.path + "?at=" + model.mediaSource.lastModified
+                    source: model.thumbnailUrl
                     asynchronous: true
 
                     /* The SDK thumbnailer respects the freedesktop.org standard and uses 128 for the small
@@ -208,7 +208,7 @@ Item {
                     // Display a play icon if the thumbnail is from a video
                     source: "../../img/icon_play.png"
                     anchors.centerIn: parent
-                    visible: model.mediaSource.type === MediaSource.Video && thumbImage.status == Image.Ready
+                    visible: model.mediaType === MediaSource.Video && thumbImage.status == Image.Ready
                 }
 
                 OrganicItemInteraction {
@@ -272,6 +272,17 @@ Item {
         flickDeceleration: maximumFlickVelocity / 3
         cacheBuffer: width
 
+        /// Range and position last reported to the model, to tell which way the list
+        /// scrolls and whether the visible items changed
+        property var reportedRange: null
+        function reportVisibleRange() {
+            reportedRange = GalleryUtility.reportVisibleRange(eventView, true,
+                                                              reportedRange);
+        }
+        onContentXChanged: reportVisibleRange()
+        onCountChanged: reportVisibleRange()
+        onWidthChanged: reportVisibleRange()
+
         model: MediaCollectionModel {
             id: mediaModel
             forCollection: organicMediaList.event
@@ -0,0 +1,4 @@
+-- Media table
+-- Index exposure time so the library can be streamed in display order.
+
+CREATE INDEX MediaTableExposureTimeIndex ON MediaTable(exposure_time);
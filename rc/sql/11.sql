@@ -0,0 +1,24 @@
+-- Directory table
+-- Store every directory once, MediaTable.filename keeps only the file name.
+-- Paths are stored with their trailing separator so a directory tree can be
+-- selected with an indexed range on the path.
+
+CREATE TABLE DirectoryTable (
+  id INTEGER PRIMARY KEY,
+  path TEXT NOT NULL UNIQUE
+);
+
+ALTER TABLE MediaTable ADD COLUMN dir_id INTEGER REFERENCES DirectoryTable ON DELETE CASCADE;
+
+-- rtrim(x, replace(x, '/', '')) strips everything after the last '/'
+INSERT OR IGNORE INTO DirectoryTable (path)
+  SELECT DISTINCT rtrim(filename, replace(filename, '/', '')) FROM MediaTable;
+
+UPDATE MediaTable SET
+  dir_id = (SELECT id FROM DirectoryTable WHERE
+            path = rtrim(MediaTable.filename, replace(MediaTable.filename, '/', ''))),
+  filename = substr(filename,
+                    length(rtrim(filename, replace(filename, '/', ''))) + 1);
+
+DROP INDEX IF EXISTS MediaTableFilenameIndex;
+CREATE INDEX MediaTableDirectoryFilenameIndex ON MediaTable(dir_id, filename);
@@ -0,0 +1,26 @@
+-- Keep a stack of non-destructive edits for each photo in PhotoEditTable.
+-- Every step holds the complete edit state of the photo after that edit, so
+-- the top step is all that is needed to render the photo, and undoing an edit
+-- drops the top step. Existing edits become the first step of their photo.
+-- The orientation column keeps using 0 for the photo's own orientation.
+
+CREATE TABLE PhotoEditStackTable (
+  media_id INTEGER NOT NULL REFERENCES MediaTable ON DELETE CASCADE,
+  step INTEGER NOT NULL,
+  crop_rectangle TEXT,
+  is_enhanced BOOLEAN DEFAULT 0,
+  orientation INT DEFAULT 0,
+  brightness REAL DEFAULT 1,
+  contrast REAL DEFAULT 1,
+  saturation REAL DEFAULT 1,
+  hue REAL DEFAULT 0,
+  PRIMARY KEY (media_id, step)
+);
+
+INSERT INTO PhotoEditStackTable (media_id, step, crop_rectangle, is_enhanced, orientation)
+  SELECT media_id, 0, crop_rectangle, is_enhanced, IFNULL(orientation, 0)
+  FROM PhotoEditTable;
+
+DROP TABLE PhotoEditTable;
+
+ALTER TABLE PhotoEditStackTable RENAME TO PhotoEditTable;
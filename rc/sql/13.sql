@@ -0,0 +1,6 @@
+-- Version 13 used to create the full-text search index. SearchTable creates it
+-- now, once the schema is up to date, and only if SQLite has FTS5, so that a
+-- build without it doesn't fail this upgrade. Databases already at version 13
+-- keep the index they have.
+
+SELECT 1;
@@ -0,0 +1,9 @@
+-- Media/album relationship table
+-- Enforce one row per album/media pair so attaching can use INSERT OR IGNORE
+-- instead of probing for an existing row first.
+
+DELETE FROM MediaAlbumTable WHERE rowid NOT IN
+  (SELECT MIN(rowid) FROM MediaAlbumTable GROUP BY album_id, media_id);
+
+DROP INDEX IF EXISTS MediaAlbumTableAlbumIndex;
+CREATE UNIQUE INDEX MediaAlbumTableAlbumMediaIndex ON MediaAlbumTable(album_id, media_id);
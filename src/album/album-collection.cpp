@@ -26,6 +26,16 @@
 // media
 #include "media-collection.h"
 
+static const bool sortKeysRegistered =
+        DataCollection::registerSortKey(AlbumCollection::creationDateTimeAscendingComparator,
+                                        AlbumCollection::creationDateTimeAscendingKey)
+        && DataCollection::registerSortKey(AlbumCollection::creationDateTimeDescendingComparator,
+                                           AlbumCollection::creationDateTimeDescendingKey);
+
+static const bool inverseComparatorsRegistered =
+        DataCollection::registerInverseComparators(AlbumCollection::creationDateTimeAscendingComparator,
+                                                   AlbumCollection::creationDateTimeDescendingComparator);
+
 /*!
  * \brief AlbumCollection::AlbumCollection
  */
@@ -83,7 +93,7 @@ AlbumCollection::AlbumCollection(MediaCollection *mediaCollection,
  */
 bool AlbumCollection::creationDateTimeAscendingComparator(DataObject* a, DataObject* b)
 {
-    return qobject_cast<Album*>(a)->creationDateTime() < qobject_cast<Album*>(b)->creationDateTime();
+    return creationDateTimeAscendingKey(a) < creationDateTimeAscendingKey(b);
 }
 
 /*!
@@ -94,7 +104,27 @@ bool AlbumCollection::creationDateTimeAscendingComparator(DataObject* a, DataObj
  */
 bool AlbumCollection::creationDateTimeDescendingComparator(DataObject* a, DataObject* b)
 {
-    return creationDateTimeAscendingComparator(b, a);
+    return creationDateTimeDescendingKey(a) < creationDateTimeDescendingKey(b);
+}
+
+/*!
+ * \brief AlbumCollection::creationDateTimeAscendingKey
+ * \param object
+ * \return
+ */
+DataObjectKey AlbumCollection::creationDateTimeAscendingKey(DataObject* object)
+{
+    return DataObjectKey(qobject_cast<Album*>(object)->creationDateTime().toMSecsSinceEpoch());
+}
+
+/*!
+ * \brief AlbumCollection::creationDateTimeDescendingKey
+ * \param object
+ * \return
+ */
+DataObjectKey AlbumCollection::creationDateTimeDescendingKey(DataObject* object)
+{
+    return DataObjectKey(-qobject_cast<Album*>(object)->creationDateTime().toMSecsSinceEpoch());
 }
 
 /*!
@@ -123,13 +153,8 @@ void AlbumCollection::onMediaAddedRemoved(const QSet<DataObject *> *added,
             Album* album = qobject_cast<Album*>(album_object);
             Q_ASSERT(album != NULL);
 
-            DataObject* object;
-            foreach (object, *removed) {
-                MediaSource* media = qobject_cast<MediaSource*>(object);
-                Q_ASSERT(media != NULL);
-
-                album->detach(media, true);
-            }
+            // One change per album rather than one per media
+            album->detachMany(*removed);
         }
     }
 }
@@ -154,11 +179,14 @@ void AlbumCollection::notifyContentsChanged(const QSet<DataObject*>* added,
             m_albumTable->addAlbum(album);
 
             // Add initial photos.
+            QList<qint64> mediaIds;
+            mediaIds.reserve(album->containedCount());
             foreach(DataObject* o, album->contained()->getAll()) {
                 MediaSource* media = qobject_cast<MediaSource*>(o);
                 Q_ASSERT(media != NULL);
-                m_albumTable->attachToAlbum(album->id(), media->id());
+                mediaIds.append(media->id());
             }
+            m_albumTable->attachManyToAlbum(album->id(), mediaIds);
         }
     }
 
@@ -50,6 +50,8 @@ public:
 
     static bool creationDateTimeAscendingComparator(DataObject* a, DataObject* b);
     static bool creationDateTimeDescendingComparator(DataObject* a, DataObject* b);
+    static DataObjectKey creationDateTimeAscendingKey(DataObject* object);
+    static DataObjectKey creationDateTimeDescendingKey(DataObject* object);
 
 protected:
     virtual void notifyAlbumCurrentPageContentsChanged(Album* album);
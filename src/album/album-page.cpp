@@ -20,11 +20,13 @@
 #include "album-page.h"
 #include "album.h"
 
+// core
+#include "typed-collection.h"
+
 // media
 #include "media-collection.h"
 
 // util
-#include "collections.h"
 #include "resource.h"
 
 /*!
@@ -92,7 +94,7 @@ QUrl AlbumPage::qmlRc() const
  */
 QQmlListProperty<MediaSource> AlbumPage::qmlMediaSourceList()
 {
-    return QQmlListProperty<MediaSource>(this, m_sourceList);
+    return TypedCollection<MediaSource>(contained()).listProperty(this);
 }
 
 /*!
@@ -123,7 +125,5 @@ void AlbumPage::notifyContainerContentsChanged(const QSet<DataObject *> *added,
 {
     ContainerSource::notifyContainerContentsChanged(added, removed);
 
-    // TODO: Can be done smarter using the added and removed; this will do for now
-    m_sourceList = CastListToType<DataObject*, MediaSource*>(contained()->getAll());
     emit mediaSourceListChanged();
 }
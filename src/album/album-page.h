@@ -73,7 +73,6 @@ private:
     Album* m_owner;
     int m_pageNumber;
     AlbumTemplatePage* m_templatePage;
-    QList<MediaSource*> m_sourceList;
 };
 
 QML_DECLARE_TYPE(AlbumPage);
@@ -24,6 +24,7 @@
 
 // core
 #include "selectable-view-collection.h"
+#include "typed-collection.h"
 
 // database
 #include "database.h"
@@ -554,7 +555,7 @@ AlbumPage* Album::getAlbumPage(int page) const
  */
 QQmlListProperty<MediaSource> Album::qmlAllMediaSources()
 {
-    return QQmlListProperty<MediaSource>(this, m_allMediaSources);
+    return TypedCollection<MediaSource>(contained()).listProperty(this);
 }
 
 /*!
@@ -572,7 +573,7 @@ void Album::setAlbumTable(AlbumTable *albumTable)
  */
 QQmlListProperty<AlbumPage> Album::qmlPages()
 {
-    return QQmlListProperty<AlbumPage>(this, m_allAlbumPages);
+    return TypedCollection<AlbumPage>(m_contentPages).listProperty(this);
 }
 
 /*!
@@ -665,21 +666,27 @@ void Album::notifyContainerContentsChanged(const QSet<DataObject*>* added,
     // If the album isn't in the DB yet, ignore for now.
     if (id() != INVALID_ID) {
         if (added != NULL) {
+            QList<qint64> mediaIds;
+            mediaIds.reserve(added->count());
             QSetIterator<DataObject*> i(*added);
             while (i.hasNext()) {
                 MediaSource* media = qobject_cast<MediaSource*>(i.next());
                 Q_ASSERT(media != NULL);
-                m_albumTable->attachToAlbum(id(), media->id());
+                mediaIds.append(media->id());
             }
+            m_albumTable->attachManyToAlbum(id(), mediaIds);
         }
 
         if (removed != NULL) {
+            QList<qint64> mediaIds;
+            mediaIds.reserve(removed->count());
             QSetIterator<DataObject*> i(*removed);
             while (i.hasNext()) {
                 MediaSource* media = qobject_cast<MediaSource*>(i.next());
                 Q_ASSERT(media != NULL);
-                m_albumTable->detachFromAlbum(id(), media->id());
+                mediaIds.append(media->id());
             }
+            m_albumTable->detachManyFromAlbum(id(), mediaIds);
         }
     }
 
@@ -728,8 +735,7 @@ void Album::notifyContainerContentsChanged(const QSet<DataObject*>* added,
         page_is_left = !page_is_left;
     }
 
-    // update QML lists and notify QML watchers
-    m_allMediaSources = CastListToType<DataObject*, MediaSource*>(contained()->getAll());
+    // notify QML watchers
     emit albumContentsChanged();
 
     m_refreshingContainer = stashed_refreshing_container;
@@ -815,8 +821,6 @@ void Album::onAlbumPageContentChanged(const QSet<DataObject*>* added,
                                       const QSet<DataObject*>* removed,
                                       bool notify)
 {
-    m_allAlbumPages = CastListToType<DataObject*, AlbumPage*>(m_contentPages->getAll());
-
     bool changed = false;
     if (m_currentPage > lastValidCurrentPage()) {
         // this deals with the closed case too
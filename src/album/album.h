@@ -185,8 +185,6 @@ private:
     bool m_newAlbum;
     int m_populatedPagesCount;
     SourceCollection* m_contentPages;
-    QList<MediaSource*> m_allMediaSources;
-    QList<AlbumPage*> m_allAlbumPages;
     bool m_refreshingContainer;
     qint64 m_id;
     QString m_coverNickname;
@@ -20,14 +20,91 @@
 #include "data-collection.h"
 #include "data-object.h"
 
+#include <QPair>
 #include <QQmlEngine>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+
+/*!
+ * \brief The DataCollection::KeyedObject struct is an object with its sort key,
+ * if the comparator has one
+ */
+struct DataCollection::KeyedObject
+{
+    bool operator<(const KeyedObject& other) const {
+        return key < other.key;
+    }
+
+    DataObjectKey key;
+    DataObject* object;
+};
+
+/*!
+ * \brief The DataCollection::KeyedObjectLessThan class orders KeyedObjects
+ * with a comparator that has no sort key
+ */
+class DataCollection::KeyedObjectLessThan
+{
+public:
+    KeyedObjectLessThan(DataObjectComparator comparator) : m_comparator(comparator) {}
+
+    bool operator()(const KeyedObject& a, const KeyedObject& b) const {
+        return m_comparator(a.object, b.object);
+    }
+
+private:
+    DataObjectComparator m_comparator;
+};
+
+/*!
+ * \brief The DataCollection::SortTask class sorts a slice of KeyedObjects by
+ * their keys on a thread of the pool. Only keys are compared, so it never calls
+ * into the DataObjects themselves.
+ */
+class DataCollection::SortTask : public QRunnable
+{
+public:
+    SortTask(KeyedObject* begin, KeyedObject* end, QSemaphore* done)
+        : m_begin(begin), m_end(end), m_done(done) {}
+
+    virtual void run() {
+        std::sort(m_begin, m_end);
+        m_done->release();
+    }
+
+private:
+    KeyedObject* m_begin;
+    KeyedObject* m_end;
+    QSemaphore* m_done;
+};
+
+typedef QList<QPair<DataObjectComparator, DataObjectSortKey> > SortKeyList;
+typedef QList<QPair<DataObjectComparator, DataObjectComparator> > ComparatorPairList;
+
+static SortKeyList& registeredSortKeys()
+{
+    static SortKeyList sortKeys;
+    return sortKeys;
+}
+
+static ComparatorPairList& registeredInverseComparators()
+{
+    static ComparatorPairList inverses;
+    return inverses;
+}
 
 /*!
  * \brief DataCollection::DataCollection
  * \param name
  */
 DataCollection::DataCollection(const QString& name)
-    : m_name(name.toUtf8()), m_comparator(defaultDataObjectComparator)
+    : m_name(name.toUtf8()), m_comparator(defaultDataObjectComparator),
+      m_sortKey(defaultDataObjectKey), m_batchDepth(0),
+      m_batchNotify(true)
 {
     // All DataCollections are registered as C++ ownership; QML should never GC them
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
@@ -41,7 +118,8 @@ DataCollection::DataCollection(const QString& name)
 void DataCollection::notifyContentsToBeChanged(const QSet<DataObject*>* added,
                                                const QSet<DataObject*>* removed)
 {
-    emit contentsAboutToBeChanged(added, removed);
+    if (m_batchDepth == 0)
+        emit contentsAboutToBeChanged(added, removed);
 }
 
 /*!
@@ -53,14 +131,72 @@ void DataCollection::notifyContentsChanged(const QSet<DataObject*>* added,
                                            const QSet<DataObject*>* removed,
                                            bool notify)
 {
+    if (m_batchDepth > 0) {
+        recordBatchChanges(added, removed, notify);
+        return;
+    }
+
     emit contentsChanged(added, removed, notify);
 }
 
+/*!
+ * \brief DataCollection::notifyRangesInserted
+ * \param ranges
+ */
+void DataCollection::notifyRangesInserted(const QList<IndexRange>* ranges)
+{
+    if (m_batchDepth == 0)
+        emit rangesInserted(ranges);
+}
+
+/*!
+ * \brief DataCollection::notifyRangesToBeRemoved
+ * \param ranges
+ */
+void DataCollection::notifyRangesToBeRemoved(const QList<IndexRange>* ranges)
+{
+    if (m_batchDepth == 0)
+        emit rangesAboutToBeRemoved(ranges);
+}
+
+/*!
+ * \brief DataCollection::notifyRangesRemoved
+ * \param ranges
+ * \param notify
+ */
+void DataCollection::notifyRangesRemoved(const QList<IndexRange>* ranges, bool notify)
+{
+    if (m_batchDepth == 0)
+        emit rangesRemoved(ranges, notify);
+}
+
+/*!
+ * \brief DataCollection::notifyBatchRewound is called by flushBatch() once it
+ * rewound the collection to its contents from when the batch started, before
+ * it replays the changes
+ * \param inserted the positions of the added objects after the batch
+ * \param removed the positions of the removed objects before the batch
+ */
+void DataCollection::notifyBatchRewound(const QList<IndexRange>* inserted,
+                                        const QList<IndexRange>* removed)
+{
+    Q_UNUSED(inserted);
+    Q_UNUSED(removed);
+}
+
 void DataCollection::notifyContentDataChanged(DataObject* object)
 {
     emit contentDataChanged(object);
 }
 
+/*!
+ * \brief DataCollection::notifyOrderingToBeChanged
+ */
+void DataCollection::notifyOrderingToBeChanged()
+{
+    emit orderingAboutToBeChanged();
+}
+
 /*!
  * \brief DataCollection::notifyOrderingChanged
  */
@@ -98,9 +234,12 @@ void DataCollection::add(DataObject* object)
 
     // Cheaper to binary insert single item than append it to list and do a
     // complete re-sort
-    binaryListInsert(object);
+    int index = binaryListInsert(object);
     m_set.insert(object);
 
+    QList<IndexRange> ranges;
+    ranges.append(IndexRange(index, index));
+    notifyRangesInserted(&ranges);
     notifyContentsChanged(&to_add, NULL, true);
 
     sanity();
@@ -133,13 +272,88 @@ void DataCollection::addMany(const QSet<DataObject*>& objects)
 
     notifyContentsToBeChanged(&to_add, NULL);
 
-    foreach (object, to_add) {
-        // Cheaper to binary insert single item than append it to list and do a
-        // complete re-sort
-        binaryListInsert(object);
-        m_set.insert(object);
+    m_set.unite(to_add);
+
+    QList<int> indexes;
+    indexes.reserve(to_add.count());
+    if (to_add.count() < MERGE_MIN_BATCH_SIZE) {
+        foreach (object, to_add) {
+            // Cheaper to binary insert single item than append it to list and do a
+            // complete re-sort
+            binaryListInsert(object);
+        }
+        // Later inserts shift the earlier ones
+        foreach (object, to_add)
+            indexes.append(indexOf(object));
+    } else {
+        // Each binary insert moves half the list on average, a merge moves it
+        // only once
+        QVector<KeyedObject> batch;
+        batch.reserve(to_add.count());
+        foreach (object, to_add) {
+            KeyedObject keyed = { keyOf(object), object };
+            batch.append(keyed);
+        }
+        sortBatch(&batch);
+        mergeSorted(batch, &indexes);
+    }
+
+    QList<IndexRange> ranges = toRanges(indexes);
+    notifyRangesInserted(&ranges);
+    notifyContentsChanged(&to_add, NULL, true);
+
+    sanity();
+}
+
+/*!
+ * \brief DataCollection::appendSorted adds objects that are already ordered
+ * according to the comparator and all sort after the current contents, so
+ * they can be appended without any comparisons.
+ * Only the seam between the current last object and the first new one is
+ * verified; if that doesn't hold, or any object is already in the collection,
+ * this falls back to addMany().
+ * \param objects
+ */
+void DataCollection::appendSorted(const QList<DataObject*>& objects)
+{
+    if (objects.isEmpty())
+        return;
+
+    if (!m_list.isEmpty()
+            && sortsAfter(m_list.count() - 1, objects.first(), keyOf(objects.first()))) {
+        addMany(objects.toSet());
+        return;
+    }
+
+    QSet<DataObject*> to_add;
+    to_add.reserve(objects.count());
+    DataObject* object;
+    foreach (object, objects) {
+        Q_ASSERT(object != NULL);
+
+        if (m_set.contains(object) || to_add.contains(object)) {
+            addMany(objects.toSet());
+            return;
+        }
+
+        to_add.insert(object);
+    }
+
+    notifyContentsToBeChanged(&to_add, NULL);
+
+    QList<IndexRange> ranges;
+    ranges.append(IndexRange(m_list.count(), m_list.count() + objects.count() - 1));
+
+    m_list.reserve(m_list.count() + objects.count());
+    m_list.append(objects);
+    if (m_sortKey != NULL) {
+        m_keys.reserve(m_list.count());
+        foreach (object, objects)
+            m_keys.append(m_sortKey(object));
     }
+    m_set.unite(to_add);
 
+    notifyRangesInserted(&ranges);
     notifyContentsChanged(&to_add, NULL, true);
 
     sanity();
@@ -161,12 +375,19 @@ void DataCollection::remove(DataObject* object, bool notify)
 
     notifyContentsToBeChanged(NULL, &to_remove);
 
+    int index = indexOf(object);
+    QList<IndexRange> ranges;
+    ranges.append(IndexRange(index, index));
+    notifyRangesToBeRemoved(&ranges);
+
+    m_list.removeAt(index);
+    if (m_sortKey != NULL)
+        m_keys.remove(index);
     bool removed = m_set.remove(object);
     Q_ASSERT(removed);
-    removed = m_list.removeOne(object);
-    Q_ASSERT(removed);
     Q_UNUSED(removed);
 
+    notifyRangesRemoved(&ranges, notify);
     notifyContentsChanged(NULL, &to_remove, notify);
 
     sanity();
@@ -204,14 +425,17 @@ void DataCollection::removeMany(const QSet<DataObject *> &objects, bool notify)
 
     notifyContentsToBeChanged(NULL, &to_remove);
 
-    foreach (object, to_remove) {
-        bool removed = m_list.removeOne(object);
-        Q_ASSERT(removed);
-        Q_UNUSED(removed);
-    }
+    QList<int> indexes;
+    indexes.reserve(to_remove.count());
+    foreach (object, to_remove)
+        indexes.append(indexOf(object));
+    QList<IndexRange> ranges = toRanges(indexes);
+    notifyRangesToBeRemoved(&ranges);
 
+    removeRanges(ranges);
     m_set.subtract(to_remove);
 
+    notifyRangesRemoved(&ranges, notify);
     notifyContentsChanged(NULL, &to_remove, notify);
 
     sanity();
@@ -233,14 +457,56 @@ void DataCollection::clear()
 
     notifyContentsToBeChanged(NULL, &all);
 
+    QList<IndexRange> ranges;
+    ranges.append(IndexRange(0, m_list.count() - 1));
+    notifyRangesToBeRemoved(&ranges);
+
     m_list.clear();
+    m_keys.clear();
     m_set.clear();
 
+    notifyRangesRemoved(&ranges, true);
     notifyContentsChanged(NULL, &all, true);
 
     sanity();
 }
 
+/*!
+ * \brief DataCollection::beginBatch starts a batch of changes. Until the
+ * matching endBatch() the changes are applied right away, but the signals
+ * reporting them are held back and merged into a single change.
+ * Batches can be nested; only the outermost one reports the changes.
+ * Removed objects must stay alive until the batch ends.
+ */
+void DataCollection::beginBatch()
+{
+    if (m_batchDepth++ == 0)
+        m_batchList = m_list;
+}
+
+/*!
+ * \brief DataCollection::endBatch ends a batch started with beginBatch(),
+ * reporting all the objects added and removed since the outermost batch
+ * started as one change
+ */
+void DataCollection::endBatch()
+{
+    Q_ASSERT(m_batchDepth > 0);
+    if (m_batchDepth == 0 || --m_batchDepth > 0)
+        return;
+
+    flushBatch();
+}
+
+/*!
+ * \brief DataCollection::isBatching
+ * \return true if between beginBatch() and endBatch()
+ */
+bool DataCollection::isBatching() const
+{
+    return m_batchDepth > 0;
+}
+
 /*!
  * \brief DataCollection::getAll
  * \return
@@ -291,6 +557,8 @@ DataObject* DataCollection::getAt(int index) const
 
 /*!
  * \brief DataCollection::indexOf
+ * As the list is kept sorted by the comparator, the object is binary searched
+ * and then looked for among the objects comparing equal to it.
  * \param object
  * \return
  */
@@ -299,6 +567,15 @@ int DataCollection::indexOf(DataObject* object) const
     if (!m_set.contains(object))
         return -1;
 
+    DataObjectKey key = keyOf(object);
+    for (int index = lowerBound(0, object, key);
+         index < m_list.count() && !sortsAfter(index, object, key); ++index) {
+        if (m_list.at(index) == object)
+            return index;
+    }
+
+    // The object's sort key changed after it was inserted, so it isn't where
+    // the comparator says it should be
     int index = m_list.indexOf(object);
 
     // Testing with set_ should prevent this possibility
@@ -316,9 +593,28 @@ void DataCollection::setComparator(DataObjectComparator comparator)
     if (m_comparator == comparator)
         return;
 
+    // Reordering isn't batched, the changes held back so far go out first
+    if (m_batchDepth > 0)
+        flushBatch();
+
+    bool fire_signal = (count() > 1);
+    if (fire_signal)
+        notifyOrderingToBeChanged();
+
+    DataObjectComparator old_comparator = m_comparator;
     m_comparator = (comparator != NULL) ? comparator : defaultDataObjectComparator;
+    m_sortKey = sortKeyFor(m_comparator);
+
+    if (areInverseComparators(old_comparator, m_comparator))
+        reverse();
+    else
+        resort();
 
-    resort(true);
+    if (fire_signal)
+        notifyOrderingChanged();
+
+    if (m_batchDepth > 0)
+        m_batchList = m_list;
 }
 
 /*!
@@ -346,66 +642,523 @@ bool DataCollection::defaultDataObjectComparator(DataObject* a, DataObject* b)
     return a->number() < b->number();
 }
 
+/*!
+ * \brief DataCollection::defaultDataObjectKey
+ * \param object
+ * \return the sort key matching defaultDataObjectComparator
+ */
+DataObjectKey DataCollection::defaultDataObjectKey(DataObject* object)
+{
+    return DataObjectKey(object->number());
+}
+
+/*!
+ * \brief DataCollection::registerSortKey declares that comparing the keys
+ * extracted by sortKey orders objects the same way as comparator. Collections
+ * using that comparator then cache the key of each object, and sort and search
+ * by comparing keys instead of calling the comparator.
+ * \param comparator
+ * \param sortKey
+ * \return true, so it can initialize a static
+ */
+bool DataCollection::registerSortKey(DataObjectComparator comparator,
+                                     DataObjectSortKey sortKey)
+{
+    registeredSortKeys().append(qMakePair(comparator, sortKey));
+    return true;
+}
+
+/*!
+ * \brief DataCollection::registerInverseComparators declares that a and b
+ * order any two objects in opposite ways, so that a collection sorted with one
+ * is sorted with the other once reversed. Objects equal for one must be equal
+ * for the other.
+ * \param a
+ * \param b
+ * \return true, so it can initialize a static
+ */
+bool DataCollection::registerInverseComparators(DataObjectComparator a,
+                                               DataObjectComparator b)
+{
+    registeredInverseComparators().append(qMakePair(a, b));
+    return true;
+}
+
+/*!
+ * \brief DataCollection::areInverseComparators
+ * \param a
+ * \param b
+ * \return true if a and b were registered as inverse of each other
+ */
+bool DataCollection::areInverseComparators(DataObjectComparator a,
+                                           DataObjectComparator b)
+{
+    const ComparatorPairList& inverses = registeredInverseComparators();
+    for (int i = 0; i < inverses.count(); ++i) {
+        if ((inverses.at(i).first == a && inverses.at(i).second == b)
+                || (inverses.at(i).first == b && inverses.at(i).second == a))
+            return true;
+    }
+
+    return false;
+}
+
+/*!
+ * \brief DataCollection::sortKeyFor
+ * \param comparator
+ * \return the sort key registered for comparator, or NULL if there is none
+ */
+DataObjectSortKey DataCollection::sortKeyFor(DataObjectComparator comparator)
+{
+    if (comparator == defaultDataObjectComparator)
+        return defaultDataObjectKey;
+
+    const SortKeyList& sortKeys = registeredSortKeys();
+    for (int i = 0; i < sortKeys.count(); ++i) {
+        if (sortKeys.at(i).first == comparator)
+            return sortKeys.at(i).second;
+    }
+
+    return NULL;
+}
+
 /*!
  * \brief DataCollection::const
  */
 void DataCollection::sanity() const
 {
     Q_ASSERT(m_list.count() == m_set.count());
+    Q_ASSERT(m_keys.count() == ((m_sortKey != NULL) ? m_list.count() : 0));
 }
 
 /*!
- * \brief DataCollection::binaryListInsert
+ * \brief DataCollection::keyOf
  * \param object
+ * \return the sort key of object, if the comparator has one
  */
-void DataCollection::binaryListInsert(DataObject* object)
+DataObjectKey DataCollection::keyOf(DataObject* object) const
 {
-    int index = -1;
+    return (m_sortKey != NULL) ? m_sortKey(object) : DataObjectKey();
+}
 
-    int low = 0;
-    int high = m_list.count();
-    for (;;) {
-        if (low == high) {
-            index = low;
+/*!
+ * \brief DataCollection::sortsBefore
+ * \param index
+ * \param object
+ * \param key the key of object
+ * \return true if the object at index is less than object
+ */
+bool DataCollection::sortsBefore(int index, DataObject* object, const DataObjectKey& key) const
+{
+    return (m_sortKey != NULL) ? m_keys.at(index) < key : m_comparator(m_list.at(index), object);
+}
 
-            break;
-        }
+/*!
+ * \brief DataCollection::sortsAfter
+ * \param index
+ * \param object
+ * \param key the key of object
+ * \return true if object is less than the object at index
+ */
+bool DataCollection::sortsAfter(int index, DataObject* object, const DataObjectKey& key) const
+{
+    return (m_sortKey != NULL) ? key < m_keys.at(index) : m_comparator(object, m_list.at(index));
+}
 
+/*!
+ * \brief DataCollection::lowerBound
+ * \param from
+ * \param object
+ * \param key the key of object
+ * \return the first position from from on that doesn't sort before object
+ */
+int DataCollection::lowerBound(int from, DataObject* object, const DataObjectKey& key) const
+{
+    int low = from;
+    int high = m_list.count();
+    while (low < high) {
         int mid = low + ((high - low) / 2);
-        DataObject* midObject = m_list[mid];
+        if (sortsBefore(mid, object, key))
+            low = mid + 1;
+        else
+            high = mid;
+    }
 
-        if (m_comparator(object, midObject)) {
-            // lowerThan
+    return low;
+}
+
+/*!
+ * \brief DataCollection::upperBound
+ * \param from
+ * \param object
+ * \param key the key of object
+ * \return the first position from from on that sorts after object
+ */
+int DataCollection::upperBound(int from, DataObject* object, const DataObjectKey& key) const
+{
+    int low = from;
+    int high = m_list.count();
+    while (low < high) {
+        int mid = low + ((high - low) / 2);
+        if (sortsAfter(mid, object, key))
             high = mid;
-        } else if (m_comparator(midObject, object)) {
-            // higherThan
+        else
             low = mid + 1;
-        } else {
-            // equalTo
-            index = mid;
+    }
+
+    return low;
+}
 
-            break;
+/*!
+ * \brief DataCollection::binaryListInsert
+ * \param object
+ * \return the position the object was inserted at
+ */
+int DataCollection::binaryListInsert(DataObject* object)
+{
+    DataObjectKey key = keyOf(object);
+    int index = upperBound(0, object, key);
+
+    m_list.insert(index, object);
+    if (m_sortKey != NULL)
+        m_keys.insert(index, key);
+
+    return index;
+}
+
+/*!
+ * \brief DataCollection::sortBatch
+ * \param batch
+ */
+void DataCollection::sortBatch(QVector<KeyedObject>* batch) const
+{
+    if (m_sortKey == NULL) {
+        std::sort(batch->begin(), batch->end(), KeyedObjectLessThan(m_comparator));
+        return;
+    }
+
+    int slices = qMin(QThread::idealThreadCount(), MAX_SORT_SLICES);
+    if (batch->count() < PARALLEL_SORT_MIN_SIZE || slices < 2) {
+        std::sort(batch->begin(), batch->end());
+        return;
+    }
+
+    // Sort one slice per core, then merge the sorted slices pairwise
+    KeyedObject* data = batch->data();
+    QVector<int> bounds;
+    for (int i = 0; i <= slices; ++i)
+        bounds.append(int(qint64(batch->count()) * i / slices));
+
+    QSemaphore done;
+    for (int i = 1; i < slices; ++i) {
+        SortTask* task = new SortTask(data + bounds[i], data + bounds[i + 1], &done);
+        if (!QThreadPool::globalInstance()->tryStart(task)) {
+            task->run();
+            delete task;
+        }
+    }
+    std::sort(data + bounds[0], data + bounds[1]);
+    done.acquire(slices - 1);
+
+    for (int width = 1; width < slices; width *= 2) {
+        for (int i = 0; i + width < slices; i += 2 * width) {
+            std::inplace_merge(data + bounds[i], data + bounds[i + width],
+                               data + bounds[qMin(i + 2 * width, slices)]);
         }
     }
+}
 
-    Q_ASSERT(index >= 0 && index <= m_list.count());
+/*!
+ * \brief DataCollection::mergeSorted merges objects ordered by the comparator
+ * into the list in a single pass. The insertion point of each object is binary
+ * searched in what is left of the list, and the objects in between are copied
+ * over in one go.
+ * \param batch
+ * \param indexes receives the positions the objects were merged at, ascending
+ */
+void DataCollection::mergeSorted(const QVector<KeyedObject>& batch, QList<int>* indexes)
+{
+    bool keyed = (m_sortKey != NULL);
+
+    QList<DataObject*> merged;
+    merged.reserve(m_list.count() + batch.count());
+    QVector<DataObjectKey> mergedKeys;
+    if (keyed)
+        mergedKeys.reserve(m_list.count() + batch.count());
+
+    int from = 0;
+    for (int i = 0; i <= batch.count(); ++i) {
+        int to = (i < batch.count()) ?
+                    upperBound(from, batch.at(i).object, batch.at(i).key) : m_list.count();
+        for (; from < to; ++from) {
+            merged.append(m_list.at(from));
+            if (keyed)
+                mergedKeys.append(m_keys.at(from));
+        }
 
-    m_list.insert(index, object);
+        if (i < batch.count()) {
+            indexes->append(merged.count());
+            merged.append(batch.at(i).object);
+            if (keyed)
+                mergedKeys.append(batch.at(i).key);
+        }
+    }
+
+    m_list.swap(merged);
+    m_keys.swap(mergedKeys);
 }
 
 /*!
- * \brief DataCollection::resort
- * \param fire_signal
+ * \brief DataCollection::recordBatchChanges adds a change to the ones held
+ * back by the current batch. An object added and removed again within the
+ * batch, or the other way round, cancels out.
+ * \param added
+ * \param removed
+ * \param notify
  */
-void DataCollection::resort(bool fire_signal)
+void DataCollection::recordBatchChanges(const QSet<DataObject*>* added,
+                                        const QSet<DataObject*>* removed,
+                                        bool notify)
 {
-    if (count() <= 1)
+    DataObject* object;
+    if (added != NULL) {
+        foreach (object, *added) {
+            if (!m_batchRemoved.remove(object))
+                m_batchAdded.insert(object);
+        }
+    }
+
+    if (removed != NULL) {
+        foreach (object, *removed) {
+            if (!m_batchAdded.remove(object))
+                m_batchRemoved.insert(object);
+        }
+
+        m_batchNotify = m_batchNotify && notify;
+    }
+}
+
+/*!
+ * \brief DataCollection::flushBatch reports the changes held back by the
+ * current batch as one change.
+ * The collection is rewound to the contents it had when the batch started, and
+ * the net changes are replayed through notifyRangesToBeRemoved(),
+ * notifyRangesRemoved() and notifyRangesInserted(), so that every signal is
+ * emitted while the collection holds the contents its positions refer to.
+ * Subclasses keeping state per position follow the rewind in
+ * notifyBatchRewound().
+ */
+void DataCollection::flushBatch()
+{
+    QSet<DataObject*> added;
+    QSet<DataObject*> removed;
+    added.swap(m_batchAdded);
+    removed.swap(m_batchRemoved);
+    QList<DataObject*> before;
+    before.swap(m_batchList);
+    bool notify = m_batchNotify;
+    m_batchNotify = true;
+
+    if (added.isEmpty() && removed.isEmpty()) {
+        if (m_batchDepth > 0)
+            m_batchList = m_list;
+
         return;
+    }
 
-    qSort(m_list.begin(), m_list.end(), m_comparator);
+    // Listeners changing this collection in turn are reported right away
+    int depth = m_batchDepth;
+    m_batchDepth = 0;
 
-    if (fire_signal)
-        notifyOrderingChanged();
+    // Where the added objects are now, and where the removed ones were when
+    // the batch started
+    QList<int> indexes;
+    DataObject* object;
+    foreach (object, added)
+        indexes.append(indexOf(object));
+    QList<IndexRange> insertedRanges = toRanges(indexes);
+
+    indexes.clear();
+    if (!removed.isEmpty()) {
+        for (int i = 0; i < before.count(); ++i) {
+            if (removed.contains(before.at(i)))
+                indexes.append(i);
+        }
+    }
+    QList<IndexRange> removedRanges = toRanges(indexes);
+
+    // The objects kept through the batch are in the same order before and
+    // after it, so their keys are taken over in turn
+    QVector<DataObjectKey> beforeKeys;
+    if (m_sortKey != NULL) {
+        beforeKeys.reserve(before.count());
+        int kept = 0;
+        foreach (object, before) {
+            if (removed.contains(object)) {
+                beforeKeys.append(keyOf(object));
+                continue;
+            }
+
+            while (added.contains(m_list.at(kept)))
+                ++kept;
+            Q_ASSERT(m_list.at(kept) == object);
+            beforeKeys.append(m_keys.at(kept++));
+        }
+    }
+
+    QList<DataObject*> list(m_list);
+    QVector<DataObjectKey> keys(m_keys);
+    m_list.swap(before);
+    m_keys.swap(beforeKeys);
+    m_set.subtract(added);
+    m_set.unite(removed);
+    notifyBatchRewound(&insertedRanges, &removedRanges);
+    sanity();
+
+    const QSet<DataObject*>* addedOrNull = added.isEmpty() ? NULL : &added;
+    const QSet<DataObject*>* removedOrNull = removed.isEmpty() ? NULL : &removed;
+
+    // notifyContentsChanged() overrides have been called as the changes were
+    // made, only the signals are left
+    emit contentsAboutToBeChanged(addedOrNull, removedOrNull);
+
+    if (!removedRanges.isEmpty()) {
+        notifyRangesToBeRemoved(&removedRanges);
+        removeRanges(removedRanges);
+        m_set.subtract(removed);
+        notifyRangesRemoved(&removedRanges, notify);
+    }
+
+    if (!insertedRanges.isEmpty()) {
+        m_list.swap(list);
+        m_keys.swap(keys);
+        m_set.unite(added);
+        notifyRangesInserted(&insertedRanges);
+    }
+
+    emit contentsChanged(addedOrNull, removedOrNull, notify);
+
+    m_batchDepth = depth;
+    if (m_batchDepth > 0)
+        m_batchList = m_list;
+
+    sanity();
+}
+
+/*!
+ * \brief DataCollection::removeRanges removes the objects in the given ranges
+ * by moving the objects kept after the first range down in a single pass
+ * \param ranges ascending and not overlapping
+ */
+void DataCollection::removeRanges(const QList<IndexRange>& ranges)
+{
+    if (ranges.isEmpty())
+        return;
+
+    bool keyed = (m_sortKey != NULL);
+    QList<DataObject*>::iterator begin = m_list.begin();
+    QVector<DataObjectKey>::iterator keys = m_keys.begin();
+    int write = ranges.first().first;
+    for (int i = 0; i < ranges.count(); ++i) {
+        int keepFrom = ranges[i].last + 1;
+        int keepTo = (i + 1 < ranges.count()) ? ranges[i + 1].first : m_list.count();
+        std::copy(begin + keepFrom, begin + keepTo, begin + write);
+        if (keyed)
+            std::copy(keys + keepFrom, keys + keepTo, keys + write);
+        write += keepTo - keepFrom;
+    }
+
+    m_list.erase(begin + write, m_list.end());
+    if (keyed)
+        m_keys.resize(write);
+}
+
+/*!
+ * \brief DataCollection::toRanges
+ * \param indexes not sorted, without duplicates
+ * \return the contiguous runs of the indexes, ascending
+ */
+QList<IndexRange> DataCollection::toRanges(QList<int> indexes)
+{
+    QList<IndexRange> ranges;
+    qSort(indexes);
+
+    int index;
+    foreach (index, indexes) {
+        if (!ranges.isEmpty() && ranges.last().last + 1 == index)
+            ranges.last().last = index;
+        else
+            ranges.append(IndexRange(index, index));
+    }
+
+    return ranges;
+}
+
+/*!
+ * \brief DataCollection::resort
+ */
+void DataCollection::resort()
+{
+    QVector<KeyedObject> batch;
+    batch.reserve(m_list.count());
+    DataObject* object;
+    foreach (object, m_list) {
+        KeyedObject keyed = { keyOf(object), object };
+        batch.append(keyed);
+    }
+    sortBatch(&batch);
+
+    QList<DataObject*> sorted;
+    sorted.reserve(batch.count());
+    m_keys.clear();
+    if (m_sortKey != NULL)
+        m_keys.reserve(batch.count());
+    for (int i = 0; i < batch.count(); ++i) {
+        sorted.append(batch.at(i).object);
+        if (m_sortKey != NULL)
+            m_keys.append(batch.at(i).key);
+    }
+    m_list.swap(sorted);
+}
+
+/*!
+ * \brief DataCollection::reverse reverses the order of the objects, which is
+ * all it takes to sort them with the inverse of the comparator they were sorted
+ * with
+ */
+void DataCollection::reverse()
+{
+    std::reverse(m_list.begin(), m_list.end());
+
+    m_keys.clear();
+    if (m_sortKey != NULL) {
+        m_keys.reserve(m_list.count());
+        DataObject* object;
+        foreach (object, m_list)
+            m_keys.append(m_sortKey(object));
+    }
+}
+
+/*!
+ * \brief DataCollection::shareContents makes this collection hold the same
+ * objects as source, in the same order. The list, the sort keys and the set are
+ * implicitly shared, and always taken together, so they agree with each other
+ * until the collection shares source's contents again.
+ * This is meant for views mirroring source, which share its contents again
+ * whenever it changes. Sharing doesn't make changes cheaper: as long as this
+ * collection holds on to them, the next change to source detaches and copies
+ * its whole list, keys and set.
+ * Changing the collection directly detaches its own copy, but those changes are
+ * lost the next time it shares source's.
+ * \param source
+ */
+void DataCollection::shareContents(const DataCollection* source)
+{
+    m_list = source->m_list;
+    m_keys = source->m_keys;
+    m_set = source->m_set;
+    m_comparator = source->m_comparator;
+    m_sortKey = source->m_sortKey;
 }
 
 /*!
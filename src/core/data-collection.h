@@ -28,12 +28,53 @@
 #include <QObject>
 #include <QSet>
 #include <QString>
+#include <QVector>
 
 class DataObject;
 
 // Defined as a LessThan comparator (return true if a is less than b)
 typedef bool (*DataObjectComparator)(DataObject* a, DataObject* b);
 
+/*!
+ * \brief The DataObjectKey struct is a precomputed sort key, compared by its
+ * primary value and then by its secondary one to break ties
+ */
+struct DataObjectKey
+{
+    DataObjectKey(qint64 primary = 0, qint64 secondary = 0)
+        : primary(primary), secondary(secondary) {}
+
+    bool operator<(const DataObjectKey& other) const {
+        return primary < other.primary
+                || (primary == other.primary && secondary < other.secondary);
+    }
+
+    qint64 primary;
+    qint64 secondary;
+};
+
+Q_DECLARE_TYPEINFO(DataObjectKey, Q_PRIMITIVE_TYPE);
+
+// Extracts the key of an object so that comparing keys orders objects like the
+// DataObjectComparator it is registered for
+typedef DataObjectKey (*DataObjectSortKey)(DataObject* object);
+
+/*!
+ * \brief The IndexRange struct is a run of adjacent positions in a
+ * DataCollection, first and last included
+ */
+struct IndexRange
+{
+    IndexRange(int first = -1, int last = -1) : first(first), last(last) {}
+
+    int count() const { return last - first + 1; }
+
+    int first;
+    int last;
+};
+
+Q_DECLARE_TYPEINFO(IndexRange, Q_MOVABLE_TYPE);
+
 /**
   * A DataCollection is a heavyweight, fully signalled collection class.  It is
   * not intended for general use but rather to hold core data structures that
@@ -55,15 +96,39 @@ signals:
                           const QSet<DataObject*>* removed,
                           bool notify);
 
+    // fired next to contentsAboutToBeChanged() and contentsChanged() with the
+    // positions of the removed DataObjects, ascending and as they were before
+    // the removal
+    void rangesAboutToBeRemoved(const QList<IndexRange>* ranges);
+    void rangesRemoved(const QList<IndexRange>* ranges, bool notify);
+
+    // fired after DataObjects have been added, before contentsChanged(), with
+    // their positions in the collection, ascending
+    void rangesInserted(const QList<IndexRange>* ranges);
+
+    // Between beginBatch() and endBatch() none of the above are fired; the
+    // changes are reported together when the batch ends, replayed from the
+    // contents the batch started with
+
     void contentDataChanged(DataObject* object);
 
-    // fired after the the DataCollection has been reordered due to a new
-    // DataObjectComparator being installed; if the new comparator doesn't
-    // actually affect the ordering, this signal will still be called
+    // fired before and after the DataCollection has been reordered due to
+    // a new DataObjectComparator being installed; if the new comparator doesn't
+    // actually affect the ordering, these signals will still be called
+    void orderingAboutToBeChanged();
     void orderingChanged();
 
 public:
     static bool defaultDataObjectComparator(DataObject* a, DataObject* b);
+    static DataObjectKey defaultDataObjectKey(DataObject* object);
+
+    static bool registerSortKey(DataObjectComparator comparator, DataObjectSortKey sortKey);
+    static DataObjectSortKey sortKeyFor(DataObjectComparator comparator);
+
+    static bool registerInverseComparators(DataObjectComparator a, DataObjectComparator b);
+    static bool areInverseComparators(DataObjectComparator a, DataObjectComparator b);
+
+    static QList<IndexRange> toRanges(QList<int> indexes);
 
     DataCollection(const QString& name);
 
@@ -71,12 +136,17 @@ public:
 
     void add(DataObject* object);
     virtual void addMany(const QSet<DataObject*>& objects);
+    void appendSorted(const QList<DataObject*>& objects);
 
     void remove(DataObject* object, bool notify);
     void removeAt(int index);
     void removeMany(const QSet<DataObject*>& objects, bool notify);
     void clear();
 
+    void beginBatch();
+    void endBatch();
+    bool isBatching() const;
+
     bool contains(DataObject* object) const;
     bool containsAll(DataCollection* collection) const;
     const QList<DataObject*>& getAll() const;
@@ -116,17 +186,63 @@ protected:
 
     virtual void notifyContentDataChanged(DataObject* object);
 
+    virtual void notifyOrderingToBeChanged();
     virtual void notifyOrderingChanged();
 
+    virtual void notifyRangesInserted(const QList<IndexRange>* ranges);
+    virtual void notifyRangesToBeRemoved(const QList<IndexRange>* ranges);
+    virtual void notifyRangesRemoved(const QList<IndexRange>* ranges, bool notify);
+    virtual void notifyBatchRewound(const QList<IndexRange>* inserted,
+                                    const QList<IndexRange>* removed);
+
+    void shareContents(const DataCollection* source);
+
 private:
+    // addMany() merges batches of at least this many objects instead of
+    // binary inserting them one by one
+    static const int MERGE_MIN_BATCH_SIZE = 8;
+    // Keyed batches of at least this many objects are sorted in slices on up
+    // to MAX_SORT_SLICES threads
+    static const int PARALLEL_SORT_MIN_SIZE = 16384;
+    static const int MAX_SORT_SLICES = 8;
+
+    struct KeyedObject;
+    class KeyedObjectLessThan;
+    class SortTask;
+
     void sanity() const;
-    void binaryListInsert(DataObject* object);
-    void resort(bool fire_signal);
+    DataObjectKey keyOf(DataObject* object) const;
+    bool sortsBefore(int index, DataObject* object, const DataObjectKey& key) const;
+    bool sortsAfter(int index, DataObject* object, const DataObjectKey& key) const;
+    int lowerBound(int from, DataObject* object, const DataObjectKey& key) const;
+    int upperBound(int from, DataObject* object, const DataObjectKey& key) const;
+    int binaryListInsert(DataObject* object);
+    void sortBatch(QVector<KeyedObject>* batch) const;
+    void mergeSorted(const QVector<KeyedObject>& batch, QList<int>* indexes);
+    void removeRanges(const QList<IndexRange>& ranges);
+    void recordBatchChanges(const QSet<DataObject*>* added,
+                            const QSet<DataObject*>* removed,
+                            bool notify);
+    void flushBatch();
+
+    void resort();
+    void reverse();
 
     QByteArray m_name;
     QList<DataObject*> m_list;
     QSet<DataObject*> m_set;
     DataObjectComparator m_comparator;
+    // Key of each object in m_list when m_comparator has a sort key registered,
+    // empty otherwise
+    DataObjectSortKey m_sortKey;
+    QVector<DataObjectKey> m_keys;
+    // Nesting depth of beginBatch(), the contents when the outermost batch
+    // started and the changes held back since
+    int m_batchDepth;
+    QList<DataObject*> m_batchList;
+    QSet<DataObject*> m_batchAdded;
+    QSet<DataObject*> m_batchRemoved;
+    bool m_batchNotify;
 };
 
 #endif  // GALLERY_DATA_COLLECTION_H_
@@ -19,27 +19,189 @@
 
 #include "selectable-view-collection.h"
 
+/*!
+ * \brief insertBits inserts unset bits at the ranges, moving the bits kept up
+ * in a single pass from the back
+ * \param ranges ascending positions after the insertion, not overlapping
+ */
+static void insertBits(QBitArray* bits, const QList<IndexRange>& ranges)
+{
+    int inserted = 0;
+    IndexRange range;
+    foreach (range, ranges)
+        inserted += range.count();
+
+    int read = bits->size() - 1;
+    bits->resize(bits->size() + inserted);
+    int write = bits->size() - 1;
+    for (int i = ranges.count() - 1; i >= 0; --i) {
+        for (; write > ranges[i].last; --write)
+            bits->setBit(write, bits->testBit(read--));
+        bits->fill(false, ranges[i].first, ranges[i].last + 1);
+        write = ranges[i].first - 1;
+    }
+}
+
+/*!
+ * \brief removeBits removes the bits in the ranges, moving the bits kept down
+ * in a single pass
+ * \param ranges ascending and not overlapping
+ */
+static void removeBits(QBitArray* bits, const QList<IndexRange>& ranges)
+{
+    int write = ranges.first().first;
+    for (int i = 0; i < ranges.count(); ++i) {
+        int keepFrom = ranges[i].last + 1;
+        int keepTo = (i + 1 < ranges.count()) ? ranges[i + 1].first : bits->size();
+        for (int read = keepFrom; read < keepTo; ++read)
+            bits->setBit(write++, bits->testBit(read));
+    }
+    bits->resize(write);
+}
+
 /*!
  * \brief SelectableViewCollection::SelectableViewCollection
  * \param name
  */
 SelectableViewCollection::SelectableViewCollection(const QString& name)
-    : ViewCollection(name), m_monitoringSelection(NULL)
+    : ViewCollection(name), m_selectedCount(0), m_selectedSetValid(true),
+      m_monitoringSelection(NULL)
+{
+}
+
+/*!
+ * \brief SelectableViewCollection::notifyRangesInserted makes room for the
+ * inserted objects, unselected
+ * \param ranges
+ */
+void SelectableViewCollection::notifyRangesInserted(const QList<IndexRange>* ranges)
+{
+    if (m_selectedCount == 0) {
+        m_selected.resize(count());
+    } else {
+        insertBits(&m_selected, *ranges);
+    }
+    Q_ASSERT(m_selected.size() == count());
+
+    // Objects added during a batch keep the selection they got meanwhile
+    if (!m_batchSelection.isEmpty()) {
+        int bit = 0;
+        IndexRange range;
+        foreach (range, *ranges) {
+            for (int index = range.first; index <= range.last; ++index) {
+                if (m_batchSelection.testBit(bit++)) {
+                    m_selected.setBit(index);
+                    ++m_selectedCount;
+                }
+            }
+        }
+        m_batchSelection.clear();
+        m_selectedSetValid = false;
+    }
+
+    ViewCollection::notifyRangesInserted(ranges);
+}
+
+/*!
+ * \brief SelectableViewCollection::notifyRangesToBeRemoved unselects the
+ * objects about to be removed
+ * \param ranges
+ */
+void SelectableViewCollection::notifyRangesToBeRemoved(const QList<IndexRange>* ranges)
 {
+    setSelected(*ranges, false);
+
+    ViewCollection::notifyRangesToBeRemoved(ranges);
 }
 
 /*!
- * \brief SelectableViewCollection::notifyContentsToBeChanged
- * \param added
+ * \brief SelectableViewCollection::notifyRangesRemoved
+ * \param ranges
+ * \param notify
+ */
+void SelectableViewCollection::notifyRangesRemoved(const QList<IndexRange>* ranges,
+                                                   bool notify)
+{
+    if (m_selectedCount == 0)
+        m_selected.resize(count());
+    else if (!ranges->isEmpty())
+        removeBits(&m_selected, *ranges);
+    Q_ASSERT(m_selected.size() == count());
+
+    ViewCollection::notifyRangesRemoved(ranges, notify);
+}
+
+/*!
+ * \brief SelectableViewCollection::notifyBatchRewound takes the objects added
+ * during the batch out of the selection, keeping their state for when they are
+ * inserted again, and makes room for the removed ones, unselected as they were
+ * when removed
+ * \param inserted
  * \param removed
  */
-void SelectableViewCollection::notifyContentsToBeChanged(const QSet<DataObject*>* added,
-                                                             const QSet<DataObject*>* removed)
+void SelectableViewCollection::notifyBatchRewound(const QList<IndexRange>* inserted,
+                                                  const QList<IndexRange>* removed)
+{
+    m_batchSelection.clear();
+    if (m_selectedCount > 0 && !inserted->isEmpty()) {
+        int total = 0;
+        IndexRange range;
+        foreach (range, *inserted)
+            total += range.count();
+
+        int selected = 0;
+        m_batchSelection.resize(total);
+        int bit = 0;
+        foreach (range, *inserted) {
+            for (int index = range.first; index <= range.last; ++index, ++bit) {
+                if (m_selected.testBit(index)) {
+                    m_batchSelection.setBit(bit);
+                    ++selected;
+                }
+            }
+        }
+
+        if (selected == 0)
+            m_batchSelection.clear();
+
+        removeBits(&m_selected, *inserted);
+        m_selectedCount -= selected;
+        m_selectedSetValid = false;
+    }
+
+    if (m_selectedCount == 0) {
+        m_selected.fill(false, count());
+    } else {
+        insertBits(&m_selected, *removed);
+    }
+    Q_ASSERT(m_selected.size() == count());
+
+    ViewCollection::notifyBatchRewound(inserted, removed);
+}
+
+/*!
+ * \brief SelectableViewCollection::notifyOrderingToBeChanged
+ */
+void SelectableViewCollection::notifyOrderingToBeChanged()
 {
-    if (removed != NULL)
-        unselectMany(*removed);
+    m_reorderedSelection = getSelectedPage(0, -1);
 
-    ViewCollection::notifyContentsToBeChanged(added, removed);
+    ViewCollection::notifyOrderingToBeChanged();
+}
+
+/*!
+ * \brief SelectableViewCollection::notifyOrderingChanged moves the selection
+ * along with the reordered objects
+ */
+void SelectableViewCollection::notifyOrderingChanged()
+{
+    m_selected.fill(false, count());
+    DataObject* object;
+    foreach (object, m_reorderedSelection)
+        m_selected.setBit(indexOf(object));
+    m_reorderedSelection.clear();
+
+    ViewCollection::notifyOrderingChanged();
 }
 
 /*!
@@ -53,6 +215,31 @@ void SelectableViewCollection::notifySelectionChanged(QSet<DataObject*>* selecte
     emit selectionChanged(selected, unselected);
 }
 
+/*!
+ * \brief SelectableViewCollection::notifySelectionRangesChanged
+ * \param ranges
+ * \param selected
+ */
+void SelectableViewCollection::notifySelectionRangesChanged(const QList<IndexRange>* ranges,
+                                                            bool selected)
+{
+    if (receivers(SIGNAL(selectionChanged(const QSet<DataObject*>*, const QSet<DataObject*>*))) > 0) {
+        QSet<DataObject*> objects;
+        IndexRange range;
+        foreach (range, *ranges) {
+            for (int index = range.first; index <= range.last; ++index)
+                objects.insert(getAt(index));
+        }
+
+        if (selected)
+            notifySelectionChanged(&objects, NULL);
+        else
+            notifySelectionChanged(NULL, &objects);
+    }
+
+    emit selectionRangesChanged(ranges, selected);
+}
+
 /*!
  * \brief SelectableViewCollection::isSelected
  * \param object
@@ -60,7 +247,22 @@ void SelectableViewCollection::notifySelectionChanged(QSet<DataObject*>* selecte
  */
 bool SelectableViewCollection::isSelected(DataObject* object) const
 {
-    return m_selected.contains(object);
+    if (m_selectedCount == 0)
+        return false;
+
+    int index = indexOf(object);
+
+    return (index >= 0) && m_selected.testBit(index);
+}
+
+/*!
+ * \brief SelectableViewCollection::isSelectedAt
+ * \param index
+ * \return
+ */
+bool SelectableViewCollection::isSelectedAt(int index) const
+{
+    return (index >= 0 && index < m_selected.size()) && m_selected.testBit(index);
 }
 
 /*!
@@ -69,7 +271,42 @@ bool SelectableViewCollection::isSelected(DataObject* object) const
  */
 const QSet<DataObject*>& SelectableViewCollection::getSelected() const
 {
-    return m_selected;
+    if (!m_selectedSetValid) {
+        m_selectedSet.clear();
+        m_selectedSet.reserve(m_selectedCount);
+        for (int index = 0; index < m_selected.size(); ++index) {
+            if (m_selected.testBit(index))
+                m_selectedSet.insert(getAt(index));
+        }
+        m_selectedSetValid = true;
+    }
+
+    return m_selectedSet;
+}
+
+/*!
+ * \brief SelectableViewCollection::getSelectedPage
+ * \param offset number of selected objects to skip
+ * \param limit most selected objects to return, or -1 for all of them
+ * \return the selected objects, in the order of the collection
+ */
+QList<DataObject*> SelectableViewCollection::getSelectedPage(int offset, int limit) const
+{
+    QList<DataObject*> page;
+    if (limit < 0)
+        limit = m_selectedCount;
+
+    for (int index = 0; index < m_selected.size() && page.count() < limit; ++index) {
+        if (!m_selected.testBit(index))
+            continue;
+
+        if (offset > 0)
+            --offset;
+        else
+            page.append(getAt(index));
+    }
+
+    return page;
 }
 
 /*!
@@ -78,7 +315,7 @@ const QSet<DataObject*>& SelectableViewCollection::getSelected() const
  */
 int SelectableViewCollection::selectedCount() const
 {
-    return m_selected.count();
+    return m_selectedCount;
 }
 
 /*!
@@ -89,17 +326,11 @@ int SelectableViewCollection::selectedCount() const
  */
 bool SelectableViewCollection::select(DataObject* object)
 {
-    if (!contains(object) || m_selected.contains(object))
+    int index = indexOf(object);
+    if (index < 0)
         return false;
 
-    m_selected.insert(object);
-
-    QSet<DataObject*> singleton;
-    singleton.insert(object);
-
-    notifySelectionChanged(&singleton, NULL);
-
-    return true;
+    return selectRange(index, index) > 0;
 }
 
 /*!
@@ -110,19 +341,11 @@ bool SelectableViewCollection::select(DataObject* object)
  */
 bool SelectableViewCollection::unselect(DataObject* object)
 {
-    if (!contains(object) || !m_selected.contains(object))
+    int index = indexOf(object);
+    if (index < 0)
         return false;
 
-    bool removed = m_selected.remove(object);
-    Q_ASSERT(removed);
-    Q_UNUSED(removed);
-
-    QSet<DataObject*> singleton;
-    singleton.insert(object);
-
-    notifySelectionChanged(NULL, &singleton);
-
-    return true;
+    return unselectRange(index, index) > 0;
 }
 
 /*!
@@ -141,7 +364,7 @@ bool SelectableViewCollection::toggleSelect(DataObject* object)
  */
 int SelectableViewCollection::selectAll()
 {
-    return selectMany(getAsSet());
+    return selectRange(0, count() - 1);
 }
 
 /*!
@@ -151,20 +374,21 @@ int SelectableViewCollection::selectAll()
  */
 int SelectableViewCollection::selectMany(const QSet<DataObject*>& select)
 {
-    // Only select objects not already selected
-    QSet<DataObject*> selected;
-    DataObject* object;
-    foreach (object, select) {
-        if (contains(object) && !isSelected(object)) {
-            m_selected.insert(object);
-            selected.insert(object);
-        }
-    }
+    return setSelected(rangesOf(select), true);
+}
 
-    if (selected.count() > 0)
-        notifySelectionChanged(&selected, NULL);
+/*!
+ * \brief SelectableViewCollection::selectRange
+ * \param first
+ * \param last
+ * \return Returns the number of items selected (that weren't selected before)
+ */
+int SelectableViewCollection::selectRange(int first, int last)
+{
+    QList<IndexRange> ranges;
+    ranges.append(IndexRange(first, last));
 
-    return selected.count();
+    return setSelected(ranges, true);
 }
 
 /*!
@@ -173,18 +397,10 @@ int SelectableViewCollection::selectMany(const QSet<DataObject*>& select)
  */
 int SelectableViewCollection::unselectAll()
 {
-    if (m_selected.count() == 0)
+    if (m_selectedCount == 0)
         return 0;
 
-    // save all that were selected to a list for the signal
-    QSet<DataObject*> unselected;
-    unselected.unite(m_selected);
-
-    m_selected.clear();
-
-    notifySelectionChanged(NULL, &unselected);
-
-    return unselected.count();
+    return unselectRange(0, count() - 1);
 }
 
 /*!
@@ -194,19 +410,83 @@ int SelectableViewCollection::unselectAll()
  */
 int SelectableViewCollection::unselectMany(const QSet<DataObject*>& unselect)
 {
-    QSet<DataObject*> unselected;
-    DataObject* object;
-    foreach (object, unselect) {
-        if (contains(object) && isSelected(object)) {
-            m_selected.remove(object);
-            unselected.insert(object);
+    if (m_selectedCount == 0)
+        return 0;
+
+    return setSelected(rangesOf(unselect), false);
+}
+
+/*!
+ * \brief SelectableViewCollection::unselectRange
+ * \param first
+ * \param last
+ * \return Returns the number of items unselected (that weren't unselected before)
+ */
+int SelectableViewCollection::unselectRange(int first, int last)
+{
+    QList<IndexRange> ranges;
+    ranges.append(IndexRange(first, last));
+
+    return setSelected(ranges, false);
+}
+
+/*!
+ * \brief SelectableViewCollection::setSelected changes the selection state of
+ * the positions in the ranges and reports the ones that actually changed
+ * \param ranges ascending
+ * \param selected
+ * \return the number of positions whose selection state changed
+ */
+int SelectableViewCollection::setSelected(const QList<IndexRange>& ranges, bool selected)
+{
+    QList<IndexRange> changed;
+    int changedCount = 0;
+    IndexRange range;
+    foreach (range, ranges) {
+        int last = qMin(range.last, m_selected.size() - 1);
+        for (int index = qMax(range.first, 0); index <= last; ++index) {
+            if (m_selected.testBit(index) == selected)
+                continue;
+
+            m_selected.setBit(index, selected);
+            ++changedCount;
+
+            if (!changed.isEmpty() && changed.last().last + 1 == index)
+                changed.last().last = index;
+            else
+                changed.append(IndexRange(index, index));
         }
     }
 
-    if (unselected.count() > 0)
-        notifySelectionChanged(NULL, &unselected);
+    if (changedCount == 0)
+        return 0;
+
+    m_selectedCount += selected ? changedCount : -changedCount;
+    m_selectedSetValid = false;
+
+    notifySelectionRangesChanged(&changed, selected);
+
+    return changedCount;
+}
+
+/*!
+ * \brief SelectableViewCollection::rangesOf
+ * \param objects
+ * \return the positions of the objects in the collection, ignoring the ones
+ * not in it
+ */
+QList<IndexRange> SelectableViewCollection::rangesOf(const QSet<DataObject*>& objects) const
+{
+    QList<int> indexes;
+    indexes.reserve(objects.count());
+    DataObject* object;
+    foreach (object, objects) {
+        int index = indexOf(object);
+        if (index >= 0)
+            indexes.append(index);
+    }
 
-    return unselected.count();
+    return toRanges(indexes);
 }
 
 /*!
@@ -23,28 +23,41 @@
 #include "data-object.h"
 #include "view-collection.h"
 
+#include <QBitArray>
+#include <QList>
 #include <QSet>
 
 /**
   * SelectableViewCollection adds the notion of selection to a ViewCollection.
   * It's primarily of use in grid or checkerboard views when the user may want
   * to perform an operation on a number of DataSources all at once.
+  *
+  * The selection is held as one bit per position, kept in step with the
+  * positions as objects are added, removed and reordered.
   */
 class SelectableViewCollection : public ViewCollection
 {
     Q_OBJECT
 
 signals:
+    // only fired when connected to, since building the sets is costly for
+    // large selections
     void selectionChanged(const QSet<DataObject*>* selected,
                           const QSet<DataObject*>* unselected);
 
+    // fired with the positions whose selection state changed to selected,
+    // ascending and coalesced
+    void selectionRangesChanged(const QList<IndexRange>* ranges, bool selected);
+
 public:
     SelectableViewCollection(const QString& name);
 
     bool isSelected(DataObject* object) const;
+    bool isSelectedAt(int index) const;
 
     int selectedCount() const;
     const QSet<DataObject*>& getSelected() const;
+    QList<DataObject*> getSelectedPage(int offset, int limit) const;
 
     template <class T>
     QSet<T> getSelectedAsType() const {
@@ -56,8 +69,10 @@ public:
     bool toggleSelect(DataObject* object);
     int selectAll();
     int selectMany(const QSet<DataObject*>& select);
+    int selectRange(int first, int last);
     int unselectAll();
     int unselectMany(const QSet<DataObject*>& unselect);
+    int unselectRange(int first, int last);
 
     // One SelectableViewCollection may monitor the selection status of another ...
     // this does *not* mirror the collection, merely alter selection state of
@@ -67,17 +82,37 @@ public:
     bool isMonitoringSelectionState();
 
 protected:
-    virtual void notifyContentsToBeChanged(const QSet<DataObject*>* added,
-                                               const QSet<DataObject*>* removed);
+    virtual void notifyRangesInserted(const QList<IndexRange>* ranges);
+    virtual void notifyRangesToBeRemoved(const QList<IndexRange>* ranges);
+    virtual void notifyRangesRemoved(const QList<IndexRange>* ranges, bool notify);
+    virtual void notifyBatchRewound(const QList<IndexRange>* inserted,
+                                    const QList<IndexRange>* removed);
+    virtual void notifyOrderingToBeChanged();
+    virtual void notifyOrderingChanged();
     virtual void notifySelectionChanged(QSet<DataObject*>* selected,
                                           QSet<DataObject*>* unselected);
+    virtual void notifySelectionRangesChanged(const QList<IndexRange>* ranges,
+                                              bool selected);
 
 private slots:
     void onMonitoringSelectionChanged(const QSet<DataObject*>* selected,
                                          const QSet<DataObject*>* unselected);
 
 private:
-    QSet<DataObject*> m_selected;
+    int setSelected(const QList<IndexRange>& ranges, bool selected);
+    QList<IndexRange> rangesOf(const QSet<DataObject*>& objects) const;
+
+    // One bit per position
+    QBitArray m_selected;
+    int m_selectedCount;
+    // Built from m_selected by getSelected() on demand
+    mutable QSet<DataObject*> m_selectedSet;
+    mutable bool m_selectedSetValid;
+    // The selected objects while the collection is being reordered
+    QList<DataObject*> m_reorderedSelection;
+    // Selection of the objects added during a batch, from notifyBatchRewound()
+    // until they are inserted again
+    QBitArray m_batchSelection;
     SelectableViewCollection* m_monitoringSelection;
 };
 
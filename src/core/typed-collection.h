@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GALLERY_TYPED_COLLECTION_H_
+#define GALLERY_TYPED_COLLECTION_H_
+
+// core
+#include "data-collection.h"
+#include "data-object.h"
+
+#include <QList>
+#include <QObject>
+#include <QQmlListProperty>
+
+/*!
+ * \brief The TypedView class presents a list of DataObjects all of type T as
+ * T*, without copying the list or casting each element at runtime.
+ *
+ * It refers to the list rather than sharing it, so it must not outlive the
+ * collection it comes from, nor be used across changes to it.
+ */
+template <class T>
+class TypedView
+{
+public:
+    class const_iterator
+    {
+    public:
+        const_iterator() {}
+        explicit const_iterator(QList<DataObject*>::const_iterator it) : m_it(it) {}
+
+        T* operator*() const { return TypedView<T>::cast(*m_it); }
+        const_iterator& operator++() { ++m_it; return *this; }
+        const_iterator operator++(int) { const_iterator old(*this); ++m_it; return old; }
+        bool operator==(const const_iterator& other) const { return m_it == other.m_it; }
+        bool operator!=(const const_iterator& other) const { return m_it != other.m_it; }
+
+    private:
+        QList<DataObject*>::const_iterator m_it;
+    };
+
+    explicit TypedView(const QList<DataObject*>& list) : m_list(&list) {}
+
+    const_iterator begin() const { return const_iterator(m_list->constBegin()); }
+    const_iterator end() const { return const_iterator(m_list->constEnd()); }
+
+    int count() const { return m_list->count(); }
+    bool isEmpty() const { return m_list->isEmpty(); }
+    T* at(int index) const { return cast(m_list->at(index)); }
+
+    // The type is only verified in debug builds
+    static T* cast(DataObject* object) {
+        Q_ASSERT(object == NULL || qobject_cast<T*>(object) != NULL);
+        return static_cast<T*>(object);
+    }
+
+private:
+    const QList<DataObject*>* m_list;
+};
+
+/*!
+ * \brief The TypedCollection class gives typed access to a DataCollection
+ * whose objects are all of type T, in place of getAllAsType() and
+ * getAtAsType(), which copy and qobject_cast.
+ */
+template <class T>
+class TypedCollection
+{
+public:
+    explicit TypedCollection(const DataCollection* collection) : m_collection(collection) {}
+
+    int count() const { return m_collection->count(); }
+    T* at(int index) const { return TypedView<T>::cast(m_collection->getAt(index)); }
+    bool contains(T* object) const { return m_collection->contains(object); }
+    int indexOf(T* object) const { return m_collection->indexOf(object); }
+    TypedView<T> all() const { return TypedView<T>(m_collection->getAll()); }
+
+    // A QML list property reading the collection live, for owner
+    QQmlListProperty<T> listProperty(QObject* owner) const {
+        return QQmlListProperty<T>(owner, const_cast<DataCollection*>(m_collection),
+                                   listCount, listAt);
+    }
+
+private:
+    static int listCount(QQmlListProperty<T>* property) {
+        return static_cast<DataCollection*>(property->data)->count();
+    }
+
+    static T* listAt(QQmlListProperty<T>* property, int index) {
+        return TypedView<T>::cast(static_cast<DataCollection*>(property->data)->getAt(index));
+    }
+
+    const DataCollection* m_collection;
+};
+
+#endif  // GALLERY_TYPED_COLLECTION_H_
@@ -24,7 +24,8 @@
  * \param name
  */
 ViewCollection::ViewCollection(const QString& name)
-    : DataCollection(name), m_monitoring(NULL), m_monitorFilter(NULL), m_monitorOrdering(false)
+    : DataCollection(name), m_monitoring(NULL), m_monitorFilter(NULL), m_monitorOrdering(false),
+      m_mirroring(false)
 {
 }
 
@@ -45,6 +46,111 @@ void ViewCollection::monitorDataCollection(const DataCollection* collection,
     m_monitoring = collection;
     m_monitorFilter = filter;
     m_monitorOrdering = monitor_ordering;
+    m_mirroring = monitor_ordering && (filter == NULL || filter->isAcceptingAll());
+
+    connectMonitored();
+
+    if (m_mirroring) {
+        QList<IndexRange> all;
+        if (m_monitoring->count() > 0)
+            all.append(IndexRange(0, m_monitoring->count() - 1));
+        onMonitoredRangesInserted(&all);
+        emit collectionChanged();
+
+        return;
+    }
+
+    // If monitoring the ordering, prime the local comparator with the monitored
+    // and make sure it's continually reflected
+    if (m_monitorOrdering)
+        setComparator(m_monitoring->comparator());
+
+    // prime the local ViewCollection with what's already in the monitored
+    // DataCollection
+    QSet<DataObject*> all(collection->getAsSet());
+    onMonitoredContentsChanged(&all, NULL, true);
+    emit collectionChanged();
+}
+
+/*!
+ * \brief ViewCollection::refilter brings the view up to date after the filter
+ * changed what it accepts. Rather than starting over, the objects of the
+ * monitored collection no longer accepted are removed and the newly accepted
+ * ones merged in, reported together; the others keep their place. The view
+ * starts or stops mirroring the monitored collection as needed.
+ */
+void ViewCollection::refilter()
+{
+    if (m_monitoring == NULL)
+        return;
+
+    bool mirroring = m_monitorOrdering
+            && (m_monitorFilter == NULL || m_monitorFilter->isAcceptingAll());
+    if (m_mirroring && mirroring)
+        return;
+
+    if (m_mirroring) {
+        // Keep the contents shared so far as a copy of our own to filter
+        disconnectMonitored();
+        m_mirroring = false;
+        connectMonitored();
+    }
+
+    QSet<DataObject*> to_add;
+    QSet<DataObject*> to_remove;
+    const QList<DataObject*>& monitored = m_monitoring->getAll();
+    DataObject* object;
+    foreach (object, monitored) {
+        bool accepted = mirroring || m_monitorFilter == NULL || m_monitorFilter->isAccepted(object);
+        if (accepted && !contains(object))
+            to_add.insert(object);
+        else if (!accepted && contains(object))
+            to_remove.insert(object);
+    }
+
+    beginBatch();
+    removeMany(to_remove, true);
+    addMany(to_add);
+    endBatch();
+
+    if (!mirroring)
+        return;
+
+    // Holding the same objects now, but objects comparing equal may not be in
+    // the same order
+    bool reordered = (getAll() != monitored);
+
+    disconnectMonitored();
+    m_mirroring = true;
+    connectMonitored();
+
+    if (reordered)
+        notifyOrderingToBeChanged();
+
+    shareContents(m_monitoring);
+
+    if (reordered)
+        notifyOrderingChanged();
+}
+
+/*!
+ * \brief ViewCollection::connectMonitored connects to the signals of the
+ * monitored collection needed to follow it, which depend on mirroring it
+ */
+void ViewCollection::connectMonitored()
+{
+    if (m_mirroring) {
+        QObject::connect(m_monitoring, SIGNAL(rangesInserted(const QList<IndexRange>*)),
+                         this, SLOT(onMonitoredRangesInserted(const QList<IndexRange>*)));
+        QObject::connect(m_monitoring, SIGNAL(rangesRemoved(const QList<IndexRange>*, bool)),
+                         this, SLOT(onMonitoredRangesRemoved(const QList<IndexRange>*, bool)));
+        QObject::connect(m_monitoring, SIGNAL(orderingAboutToBeChanged()), this,
+                         SLOT(onMonitoredOrderingToBeChanged()));
+        QObject::connect(m_monitoring, SIGNAL(orderingChanged()), this,
+                         SLOT(onMonitoredOrderingChanged()));
+
+        return;
+    }
 
     // monitor DataCollection for added/removed DataObjects and add them to this
     // ViewCollection according to the filter
@@ -58,21 +164,18 @@ void ViewCollection::monitorDataCollection(const DataCollection* collection,
                      this,
                      SLOT(onMonitoredContentDataChanged(DataObject*)));
 
-
-    // If monitoring the ordering, prime the local comparator with the monitored
-    // and make sure it's continually reflected
     if (m_monitorOrdering) {
-        setComparator(m_monitoring->comparator());
-
         QObject::connect(m_monitoring, SIGNAL(orderingChanged()), this,
                          SLOT(onMonitoredOrderingChanged()));
     }
+}
 
-    // prime the local ViewCollection with what's already in the monitored
-    // DataCollection
-    QSet<DataObject*> all(collection->getAsSet());
-    onMonitoredContentsChanged(&all, NULL, true);
-    emit collectionChanged();
+/*!
+ * \brief ViewCollection::disconnectMonitored undoes connectMonitored()
+ */
+void ViewCollection::disconnectMonitored()
+{
+    QObject::disconnect(m_monitoring, 0, this, 0);
 }
 
 /*!
@@ -93,12 +196,21 @@ bool ViewCollection::isMonitoring() const
     return m_monitoring != NULL;
 }
 
+/*!
+ * \brief ViewCollection::isMirroring
+ * \return true if the view shares the contents of the monitored collection
+ */
+bool ViewCollection::isMirroring() const
+{
+    return m_mirroring;
+}
+
 /*!
  * \brief ViewCollection::notifyOrderingChanged
  */
 void ViewCollection::notifyOrderingChanged()
 {
-    if (m_monitorOrdering)
+    if (m_monitorOrdering && !m_mirroring)
         qWarning("ViewCollection monitoring a DataCollection's ordering changed "
                  "its own comparator: this is unstable");
 
@@ -155,12 +267,77 @@ void ViewCollection::onMonitoredContentDataChanged(DataObject* object)
     }
 }
 
+/*!
+ * \brief ViewCollection::onMonitoredOrderingToBeChanged is only connected when
+ * mirroring; other views report their own reordering from setComparator()
+ */
+void ViewCollection::onMonitoredOrderingToBeChanged()
+{
+    notifyOrderingToBeChanged();
+}
+
 /*!
  * \brief ViewCollection::onMonitoredOrderingChanged
  */
 void ViewCollection::onMonitoredOrderingChanged()
 {
+    if (m_mirroring) {
+        shareContents(m_monitoring);
+        notifyOrderingChanged();
+        return;
+    }
+
     // simply re-sort the local collection with the monitored collection's new
     // comparator
     setComparator(m_monitoring->comparator());
 }
+
+/*!
+ * \brief ViewCollection::onMonitoredRangesInserted shares the monitored
+ * collection's contents again and reports the same insertions
+ * \param ranges
+ */
+void ViewCollection::onMonitoredRangesInserted(const QList<IndexRange>* ranges)
+{
+    QSet<DataObject*> added;
+    IndexRange range;
+    foreach (range, *ranges) {
+        for (int index = range.first; index <= range.last; ++index)
+            added.insert(m_monitoring->getAt(index));
+    }
+
+    if (!added.isEmpty())
+        notifyContentsToBeChanged(&added, NULL);
+
+    shareContents(m_monitoring);
+
+    if (!added.isEmpty()) {
+        notifyRangesInserted(ranges);
+        notifyContentsChanged(&added, NULL, true);
+    }
+}
+
+/*!
+ * \brief ViewCollection::onMonitoredRangesRemoved shares the monitored
+ * collection's contents again and reports the same removals
+ * \param ranges
+ * \param notify
+ */
+void ViewCollection::onMonitoredRangesRemoved(const QList<IndexRange>* ranges, bool notify)
+{
+    // Not shared again yet, so the removed objects are still here
+    QSet<DataObject*> removed;
+    IndexRange range;
+    foreach (range, *ranges) {
+        for (int index = range.first; index <= range.last; ++index)
+            removed.insert(getAt(index));
+    }
+
+    notifyContentsToBeChanged(NULL, &removed);
+    notifyRangesToBeRemoved(ranges);
+
+    shareContents(m_monitoring);
+
+    notifyRangesRemoved(ranges, notify);
+    notifyContentsChanged(NULL, &removed, notify);
+}
@@ -26,6 +26,10 @@
 class IDataFilter {
 public:
     virtual bool isAccepted(DataObject* item) = 0;
+
+    // Filters returning true promise to accept every item for as long as they
+    // are used; views can then mirror the collection they monitor
+    virtual bool isAcceptingAll() const { return false; }
 };
 
 /**
@@ -41,6 +45,10 @@ public:
   * ViewCollection to maintain a coherent representation of DataObject filtered
   * by a predicate function, and even maintaining the same sort ordering.
   *
+  * A ViewCollection that keeps every DataObject and the ordering of the
+  * collection it monitors is a mirror: instead of a copy of its own, it
+  * shares the monitored collection's storage and forwards its index ranges.
+  *
   * The "view" in ViewCollection should not be thought of in the sense of
   * model-view-controller, although there are some similarities.  Rather, it
   * should be thought of a table view in database parlance -- a slice of a
@@ -60,7 +68,9 @@ public:
     // DataCollection) will hold DataSources of varied finalized types.
     void monitorDataCollection(const DataCollection* collection, IDataFilter* filter,
                                bool monitor_ordering);
+    void refilter();
     bool isMonitoring() const;
+    bool isMirroring() const;
     const DataCollection* collection() const;
 
 signals:
@@ -74,12 +84,19 @@ private slots:
                                     const QSet<DataObject*>* removed,
                                     bool notify);
     void onMonitoredContentDataChanged(DataObject* object);
+    void onMonitoredOrderingToBeChanged();
     void onMonitoredOrderingChanged();
+    void onMonitoredRangesInserted(const QList<IndexRange>* ranges);
+    void onMonitoredRangesRemoved(const QList<IndexRange>* ranges, bool notify);
 
 private:
     const DataCollection* m_monitoring;
     IDataFilter* m_monitorFilter;
     bool m_monitorOrdering;
+    bool m_mirroring;
+
+    void connectMonitored();
+    void disconnectMonitored();
 };
 
 #endif  // GALLERY_VIEW_COLLECTION_H_
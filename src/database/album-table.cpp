@@ -19,6 +19,7 @@
 
 #include "album-table.h"
 #include "database.h"
+#include "search-table.h"
 
 // album
 #include "album.h"
@@ -46,7 +47,7 @@ void AlbumTable::getAlbums(QList<Album*>* albumSet)
     QSqlQuery query(*m_db->getDB());
     query.prepare("SELECT id, title, subtitle, time_added, is_closed, current_page, "
                   "cover_nickname FROM AlbumTable ORDER BY time_added DESC");
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
     while (query.next()) {
@@ -87,10 +88,11 @@ void AlbumTable::addAlbum(Album* album)
     query.bindValue(":is_closed", album->isClosed());
     query.bindValue(":page", album->currentPage());
     query.bindValue(":cover_nickname", album->coverNickname());
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
     album->setId(query.lastInsertId().toLongLong());
+    m_db->getSearchTable()->indexAlbum(album->id(), album->title(), album->subtitle());
 }
 
 /*!
@@ -105,65 +107,129 @@ void AlbumTable::removeAlbum(Album* album)
     QSqlQuery query(*m_db->getDB());
     query.prepare("DELETE FROM AlbumTable WHERE id = :id");
     query.bindValue(":id", album->id());
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
+    m_db->getSearchTable()->removeAlbum(album->id());
+
     album->setId(INVALID_ID);
 }
 
 /*!
- * \brief AlbumTable::isAttachedToAlbum check if a photo is attached to album
+ * \brief AlbumTable::attachToAlbum adds a photo to an album.
  * \param albumId
  * \param mediaId
  */
-bool AlbumTable::isAttachedToAlbum(qint64 albumId, qint64 mediaId) const
+void AlbumTable::attachToAlbum(qint64 albumId, qint64 mediaId)
 {
+    // The (album_id, media_id) pair is unique, so attaching twice is a no-op
     QSqlQuery query(*m_db->getDB());
-
-    query.prepare("SELECT COUNT(*) FROM MediaAlbumTable WHERE album_id = :album_id AND media_id = :media_id");
+    query.prepare("INSERT OR IGNORE INTO MediaAlbumTable (album_id, media_id) "
+                  "VALUES (:album_id, :media_id)");
     query.bindValue(":album_id", albumId);
     query.bindValue(":media_id", mediaId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
-    else if (query.next() && (query.value(0).toInt() > 0))
-        return true;
 
-    return false;
+    m_db->getSearchTable()->notifyAlbumMediaChanged();
 }
 
 /*!
- * \brief AlbumTable::attachToAlbum adds a photo to an album.
+ * \brief AlbumTable::detachFromAlbum removes a photo from an album.
  * \param albumId
  * \param mediaId
  */
-void AlbumTable::attachToAlbum(qint64 albumId, qint64 mediaId)
+void AlbumTable::detachFromAlbum(qint64 albumId, qint64 mediaId)
 {
-    if (isAttachedToAlbum(albumId, mediaId))
-        return;
-
     QSqlQuery query(*m_db->getDB());
-    query.prepare("INSERT INTO MediaAlbumTable (album_id, media_id) "
-                  "VALUES (:album_id, :media_id)");
+    query.prepare("DELETE FROM MediaAlbumTable WHERE album_id = :album_id AND "
+                  "media_id = :media_id");
     query.bindValue(":album_id", albumId);
     query.bindValue(":media_id", mediaId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
+
+    m_db->getSearchTable()->notifyAlbumMediaChanged();
 }
 
 /*!
- * \brief AlbumTable::detachFromAlbum removes a photo from an album.
+ * \brief AlbumTable::attachManyToAlbum adds several photos to an album in a
+ * single transaction
  * \param albumId
- * \param mediaId
+ * \param mediaIds
  */
-void AlbumTable::detachFromAlbum(qint64 albumId, qint64 mediaId)
+void AlbumTable::attachManyToAlbum(qint64 albumId, const QList<qint64>& mediaIds)
 {
-    QSqlQuery query(*m_db->getDB());
+    if (mediaIds.isEmpty())
+        return;
+
+    if (mediaIds.count() == 1) {
+        attachToAlbum(albumId, mediaIds.first());
+        return;
+    }
+
+    // Without a transaction the statements are still run, one commit each
+    QSqlDatabase* db = m_db->getDB();
+    bool transaction = db->transaction();
+    if (!transaction)
+        qWarning() << "Could not start a transaction:" << db->lastError().text();
+
+    QSqlQuery query(*db);
+    query.prepare("INSERT OR IGNORE INTO MediaAlbumTable (album_id, media_id) "
+                  "VALUES (:album_id, :media_id)");
+    foreach (qint64 mediaId, mediaIds) {
+        query.bindValue(":album_id", albumId);
+        query.bindValue(":media_id", mediaId);
+        if (!m_db->exec(query))
+            m_db->logSqlError(query);
+    }
+
+    if (transaction && !db->commit()) {
+        qWarning() << "Could not commit album attachments:" << db->lastError().text();
+        db->rollback();
+    }
+
+    m_db->getSearchTable()->notifyAlbumMediaChanged();
+}
+
+/*!
+ * \brief AlbumTable::detachManyFromAlbum removes several photos from an album
+ * in a single transaction
+ * \param albumId
+ * \param mediaIds
+ */
+void AlbumTable::detachManyFromAlbum(qint64 albumId, const QList<qint64>& mediaIds)
+{
+    if (mediaIds.isEmpty())
+        return;
+
+    if (mediaIds.count() == 1) {
+        detachFromAlbum(albumId, mediaIds.first());
+        return;
+    }
+
+    // Without a transaction the statements are still run, one commit each
+    QSqlDatabase* db = m_db->getDB();
+    bool transaction = db->transaction();
+    if (!transaction)
+        qWarning() << "Could not start a transaction:" << db->lastError().text();
+
+    QSqlQuery query(*db);
     query.prepare("DELETE FROM MediaAlbumTable WHERE album_id = :album_id AND "
                   "media_id = :media_id");
-    query.bindValue(":album_id", albumId);
-    query.bindValue(":media_id", mediaId);
-    if (!query.exec())
-        m_db->logSqlError(query);
+    foreach (qint64 mediaId, mediaIds) {
+        query.bindValue(":album_id", albumId);
+        query.bindValue(":media_id", mediaId);
+        if (!m_db->exec(query))
+            m_db->logSqlError(query);
+    }
+
+    if (transaction && !db->commit()) {
+        qWarning() << "Could not commit album detachments:" << db->lastError().text();
+        db->rollback();
+    }
+
+    m_db->getSearchTable()->notifyAlbumMediaChanged();
 }
 
 /*!
@@ -177,7 +243,7 @@ void AlbumTable::mediaForAlbum(qint64 albumId, QList<qint64>* list) const
     query.prepare("SELECT media_id FROM MediaAlbumTable WHERE "
                   "album_id = :album_id");
     query.bindValue(":album_id", albumId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
     while (query.next())
@@ -196,7 +262,7 @@ void AlbumTable::setIsClosed(qint64 albumId, bool isClosed)
                   "id = :album_id");
     query.bindValue(":is_closed", isClosed);
     query.bindValue(":album_id", albumId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 }
 
@@ -212,7 +278,7 @@ void AlbumTable::setCurrentPage(qint64 albumId, int page)
                   "id = :album_id");
     query.bindValue(":page", page);
     query.bindValue(":album_id", albumId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 }
 
@@ -228,7 +294,7 @@ void AlbumTable::setCoverNickname(qint64 albumId, QString coverNickname)
                   "id = :album_id");
     query.bindValue(":cover_nickname", coverNickname);
     query.bindValue(":album_id", albumId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 }
 
@@ -244,8 +310,12 @@ void AlbumTable::setTitle(qint64 albumId, QString title)
                   "id = :album_id");
     query.bindValue(":title", title);
     query.bindValue(":album_id", albumId);
-    if (!query.exec())
+    if (!m_db->exec(query)) {
         m_db->logSqlError(query);
+        return;
+    }
+
+    reindexAlbum(albumId);
 }
 
 /*!
@@ -260,6 +330,29 @@ void AlbumTable::setSubtitle(qint64 albumId, QString subtitle)
                   "id = :album_id");
     query.bindValue(":subtitle", subtitle);
     query.bindValue(":album_id", albumId);
-    if (!query.exec())
+    if (!m_db->exec(query)) {
+        m_db->logSqlError(query);
+        return;
+    }
+
+    reindexAlbum(albumId);
+}
+
+/*!
+ * \brief AlbumTable::reindexAlbum updates the search index with the title and
+ * subtitle stored for an album
+ * \param albumId
+ */
+void AlbumTable::reindexAlbum(qint64 albumId)
+{
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("SELECT title, subtitle FROM AlbumTable WHERE id = :album_id");
+    query.bindValue(":album_id", albumId);
+    if (!m_db->exec(query) || !query.next()) {
         m_db->logSqlError(query);
+        return;
+    }
+
+    m_db->getSearchTable()->indexAlbum(albumId, query.value(0).toString(),
+                                       query.value(1).toString());
 }
@@ -44,6 +44,9 @@ public:
     void attachToAlbum(qint64 albumId, qint64 mediaId);
     void detachFromAlbum(qint64 albumId, qint64 mediaId);
 
+    void attachManyToAlbum(qint64 albumId, const QList<qint64>& mediaIds);
+    void detachManyFromAlbum(qint64 albumId, const QList<qint64>& mediaIds);
+
     void mediaForAlbum(qint64 albumId, QList<qint64>* list) const;
 
     void setIsClosed(qint64 albumId, bool isClosed);
@@ -55,9 +58,9 @@ public:
     void setSubtitle(qint64 albumId, QString subtitle);
 
 private:
-    Database* m_db;
+    void reindexAlbum(qint64 albumId);
 
-    bool isAttachedToAlbum(qint64 albumId, qint64 mediaId) const;
+    Database* m_db;
 };
 
 #endif // ALBUMTABLE_H
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "database-backup.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QSettings>
+#include <QtEndian>
+
+#include <cstdio>
+#include <sqlite3.h>
+
+// Don't take backups more often than this, in seconds
+static const int MIN_BACKUP_INTERVAL = 15 * 60;
+// Pages copied per step; the source is only locked while a step runs
+static const int BACKUP_PAGES_PER_STEP = 256;
+// Pause between two steps, in milliseconds
+static const int BACKUP_STEP_PAUSE = 10;
+
+// Offset of the file change counter in the SQLite database header
+static const int CHANGE_COUNTER_OFFSET = 24;
+
+/*!
+ * \brief readChangeCounter reads the file change counter from the header of an
+ * SQLite database. It's incremented by every transaction that changes the file.
+ * \param fileName
+ * \param counter
+ * \return false if the file couldn't be read
+ */
+static bool readChangeCounter(const QString& fileName, quint32* counter)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(CHANGE_COUNTER_OFFSET))
+        return false;
+
+    QByteArray bytes = file.read(sizeof(quint32));
+    if (bytes.size() != sizeof(quint32))
+        return false;
+
+    *counter = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(bytes.constData()));
+    return true;
+}
+
+/*!
+ * \brief settingsGroup returns the QSettings group holding the state of the
+ * backup at backupName
+ * \param backupName
+ * \return
+ */
+static QString settingsGroup(const QString& backupName)
+{
+    return QString("DatabaseBackup/") + QString(backupName).replace('/', '_');
+}
+
+/*!
+ * \brief DatabaseBackup::DatabaseBackup
+ * \param databaseName the database file to back up
+ * \param backupName the backup file
+ * \param parent
+ */
+DatabaseBackup::DatabaseBackup(const QString& databaseName, const QString& backupName,
+                               QObject* parent)
+    : QObject(parent),
+      m_databaseName(databaseName),
+      m_backupName(backupName),
+      m_cancelled(0)
+{
+}
+
+/*!
+ * \brief DatabaseBackup::forget drops what is known about the last backup, so
+ * the next call to createBackup() isn't skipped
+ * \param backupName
+ */
+void DatabaseBackup::forget(const QString& backupName)
+{
+    QSettings settings("com.ubuntu.gallery", "com.ubuntu.gallery");
+    settings.remove(settingsGroup(backupName));
+}
+
+/*!
+ * \brief DatabaseBackup::cancel abandons the backup being taken, if any, and
+ * the ones requested afterwards; the previous backup is left in place
+ */
+void DatabaseBackup::cancel()
+{
+    m_cancelled.store(1);
+}
+
+/*!
+ * \brief DatabaseBackup::createBackup updates the backup, unless the database
+ * didn't change since the last one or the last one is too recent
+ */
+void DatabaseBackup::createBackup()
+{
+    quint32 changeCounter = 0;
+    if (!readChangeCounter(m_databaseName, &changeCounter))
+        return;
+
+    QSettings settings("com.ubuntu.gallery", "com.ubuntu.gallery");
+    settings.beginGroup(settingsGroup(m_backupName));
+
+    if (QFile::exists(m_backupName)) {
+        if (settings.contains("changeCounter") &&
+                settings.value("changeCounter").toUInt() == changeCounter)
+            return;
+
+        QDateTime lastBackup = settings.value("lastBackup").toDateTime();
+        if (lastBackup.isValid() &&
+                lastBackup.secsTo(QDateTime::currentDateTimeUtc()) < MIN_BACKUP_INTERVAL)
+            return;
+    }
+
+    // Write to a temporary file first, so a valid backup exists at any time
+    QString target = m_backupName + ".tmp";
+    QFile::remove(target);
+    if (!copyDatabase(target)) {
+        QFile::remove(target);
+        return;
+    }
+
+    if (::rename(QFile::encodeName(target).constData(),
+                 QFile::encodeName(m_backupName).constData()) != 0) {
+        qDebug() << "Could not replace existing backup.";
+        QFile::remove(target);
+        return;
+    }
+
+    settings.setValue("changeCounter", changeCounter);
+    settings.setValue("lastBackup", QDateTime::currentDateTimeUtc());
+}
+
+/*!
+ * \brief DatabaseBackup::copyDatabase copies the database into target using
+ * the online backup API
+ * \param target
+ * \return false if the copy failed or was cancelled
+ */
+bool DatabaseBackup::copyDatabase(const QString& target) const
+{
+    sqlite3* source = 0;
+    sqlite3* destination = 0;
+    bool complete = false;
+
+    int rc = sqlite3_open_v2(QFile::encodeName(m_databaseName).constData(), &source,
+                             SQLITE_OPEN_READONLY, 0);
+    if (rc == SQLITE_OK)
+        rc = sqlite3_open_v2(QFile::encodeName(target).constData(), &destination,
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, 0);
+
+    if (rc == SQLITE_OK) {
+        sqlite3_backup* backup = sqlite3_backup_init(destination, "main", source, "main");
+        if (backup != 0) {
+            while (m_cancelled.load() == 0) {
+                rc = sqlite3_backup_step(backup, BACKUP_PAGES_PER_STEP);
+                if (rc == SQLITE_DONE) {
+                    complete = true;
+                    break;
+                }
+
+                if (rc != SQLITE_OK && rc != SQLITE_BUSY && rc != SQLITE_LOCKED)
+                    break;
+
+                sqlite3_sleep(BACKUP_STEP_PAUSE);
+            }
+
+            rc = sqlite3_backup_finish(backup);
+        } else {
+            rc = sqlite3_errcode(destination);
+        }
+    }
+
+    if (rc != SQLITE_OK) {
+        qDebug() << "Could not back up database:"
+                 << sqlite3_errmsg(destination != 0 ? destination : source);
+    }
+
+    sqlite3_close(destination);
+    sqlite3_close(source);
+
+    return rc == SQLITE_OK && complete;
+}
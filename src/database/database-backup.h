@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DATABASE_BACKUP_H
+#define DATABASE_BACKUP_H
+
+#include <QAtomicInt>
+#include <QObject>
+#include <QString>
+
+/*!
+ * \brief The DatabaseBackup class keeps the auto-backup of the database up to
+ * date. It is supposed to live in its own thread.
+ *
+ * The backup is taken with SQLite's online backup API through a separate
+ * connection, a few pages at a time, so the application can keep using the
+ * database meanwhile. It is skipped when the database's file change counter
+ * hasn't moved since the last backup, and not taken more often than
+ * MIN_BACKUP_INTERVAL. A backup being taken can be abandoned with cancel(), from
+ * any thread.
+ */
+class DatabaseBackup : public QObject
+{
+    Q_OBJECT
+
+public:
+    DatabaseBackup(const QString& databaseName, const QString& backupName,
+                   QObject* parent = 0);
+
+    static void forget(const QString& backupName);
+
+    void cancel();
+
+public slots:
+    void createBackup();
+
+private:
+    bool copyDatabase(const QString& target) const;
+
+    QString m_databaseName;
+    QString m_backupName;
+    QAtomicInt m_cancelled;
+};
+
+#endif // DATABASE_BACKUP_H
@@ -20,13 +20,20 @@
 
 #include "database.h"
 #include "album-table.h"
+#include "database-backup.h"
 #include "media-table.h"
+#include "photo-edit-table.h"
 #include "resource.h"
+#include "search-table.h"
+#include "sql-profiler.h"
 
 #include <QFile>
 #include <QSqlTableModel>
 #include <QtSql>
 
+// Interval between two attempts to update the backup, in milliseconds
+static const int BACKUP_INTERVAL = 15 * 60 * 1000;
+
 /*!
  * \brief Database::Database
  * \param databaseDir directory to load/store the database
@@ -37,7 +44,9 @@ Database::Database(Resource *resource, QObject* parent) :
     QObject(parent),
     m_databaseDirectory(resource->databaseDirectory()),
     m_sqlSchemaDirectory(resource->getRcUrl("sql").path()),
-    m_db(new QSqlDatabase())
+    m_db(new QSqlDatabase()),
+    m_profiler(SqlProfiler::isEnabled() ? new SqlProfiler(m_db) : 0),
+    m_backup(0)
 {
     if (!QFile::exists(m_databaseDirectory)) {
         QDir dir;
@@ -48,6 +57,8 @@ Database::Database(Resource *resource, QObject* parent) :
 
     m_albumTable = new AlbumTable(this, this);
     m_mediaTable = new MediaTable(this, resource, this);
+    m_photoEditTable = new PhotoEditTable(this, this);
+    m_searchTable = new SearchTable(this, this);
 
     // Open the database.
     if (!openDB())
@@ -55,26 +66,30 @@ Database::Database(Resource *resource, QObject* parent) :
 
     // Attempt a query to make sure the DB is valid.
     QSqlQuery test_query(*m_db);
-    if (!test_query.exec("SELECT * FROM SQLITE_MASTER LIMIT 1")) {
+    if (!exec(test_query, "SELECT * FROM SQLITE_MASTER LIMIT 1")) {
         logSqlError(test_query);
         restoreFromBackup();
     }
 
+    startBackups();
+
     QSqlQuery query(*m_db);
     // Turn synchronous off.
-    if (!query.exec("PRAGMA synchronous = OFF")) {
+    if (!exec(query, "PRAGMA synchronous = OFF")) {
         logSqlError(query);
         return;
     }
 
     // Enable foreign keys.
-    if (!query.exec("PRAGMA foreign_keys = ON")) {
+    if (!exec(query, "PRAGMA foreign_keys = ON")) {
         logSqlError(query);
         return;
     }
 
     // Update if needed.
     upgradeSchema(schemaVersion());
+
+    m_searchTable->createIndex();
 }
 
 /*!
@@ -84,9 +99,12 @@ Database::~Database()
 {
     delete m_albumTable;
     delete m_mediaTable;
+    delete m_photoEditTable;
+    delete m_searchTable;
+    delete m_profiler;
     delete m_db;
 
-    createBackup();
+    stopBackups();
 }
 
 /*!
@@ -99,6 +117,34 @@ void Database::logSqlError(QSqlQuery& q) const
     qDebug() << "SQLite string: " << q.lastQuery();
 }
 
+/*!
+ * \brief Database::exec Executes a prepared query, timing it when profiling is
+ * enabled
+ * \param query
+ * \return the result of QSqlQuery::exec()
+ */
+bool Database::exec(QSqlQuery& query) const
+{
+    if (m_profiler)
+        return m_profiler->exec(query);
+
+    return query.exec();
+}
+
+/*!
+ * \brief Database::exec Executes statement, timing it when profiling is enabled
+ * \param query
+ * \param statement
+ * \return the result of QSqlQuery::exec()
+ */
+bool Database::exec(QSqlQuery& query, const QString& statement) const
+{
+    if (m_profiler)
+        return m_profiler->exec(query, statement);
+
+    return query.exec(statement);
+}
+
 /*!
  * \brief Database::openDB Open the SQLite database
  * \return
@@ -122,7 +168,7 @@ bool Database::openDB()
 int Database::schemaVersion() const
 {
     QSqlQuery query(*m_db);
-    if (!query.exec("PRAGMA user_version") || !query.next()) {
+    if (!exec(query, "PRAGMA user_version") || !query.next()) {
         logSqlError(query);
         return -1;
     }
@@ -139,7 +185,7 @@ void Database::setSchemaVersion(int version)
     // Must use string concats here since prepared statements
     // appear not to work with PRAGMAs.
     QSqlQuery query(*m_db);
-    if (!query.exec("PRAGMA user_version = " + QString::number(version)))
+    if (!exec(query, "PRAGMA user_version = " + QString::number(version)))
         logSqlError(query);
 }
 
@@ -196,7 +242,7 @@ bool Database::executeSqlFile(QFile& file)
 
         // Execute each statement.
         QSqlQuery query(*m_db);
-        if (!query.exec(statement)) {
+        if (!exec(query, statement)) {
             qDebug() << "Error executing database file: " << file.fileName();
             logSqlError(query);
         }
@@ -223,6 +269,24 @@ MediaTable* Database::getMediaTable() const
     return m_mediaTable;
 }
 
+/*!
+ * \brief Database::getPhotoEditTable
+ * \return
+ */
+PhotoEditTable* Database::getPhotoEditTable() const
+{
+    return m_photoEditTable;
+}
+
+/*!
+ * \brief Database::getSearchTable
+ * \return
+ */
+SearchTable* Database::getSearchTable() const
+{
+    return m_searchTable;
+}
+
 /*!
  * \brief Database::getDB
  * \return
@@ -278,19 +342,48 @@ void Database::restoreFromBackup()
         file.copy(getDBname());
     }
 
+    // The restored file has a change counter of its own
+    DatabaseBackup::forget(getDBBackupName());
+
     openDB();
 }
 
 /*!
- * \brief Database::create_backup Creates the auto-backup
+ * \brief Database::startBackups starts keeping the auto-backup up to date in
+ * the background
  */
-void Database::createBackup()
+void Database::startBackups()
 {
-    QFile old_backup(getDBBackupName());
-    if (!old_backup.remove())
-        qDebug() << "Could not remove existing backup.";
+    m_backup = new DatabaseBackup(getDBname(), getDBBackupName());
+    m_backup->moveToThread(&m_backupThread);
+    QObject::connect(&m_backupThread, SIGNAL(finished()),
+                     m_backup, SLOT(deleteLater()));
+
+    m_backupTimer.setInterval(BACKUP_INTERVAL);
+    QObject::connect(&m_backupTimer, SIGNAL(timeout()),
+                     m_backup, SLOT(createBackup()));
+
+    m_backupThread.start(QThread::LowestPriority);
+    m_backupTimer.start();
+
+    // Nothing is backed up on exit, so catch up with the changes of the last
+    // session now
+    QMetaObject::invokeMethod(m_backup, "createBackup", Qt::QueuedConnection);
+}
+
+/*!
+ * \brief Database::stopBackups stops the backup thread. A backup still being
+ * taken is abandoned, the periodic ones keep the last backup recent enough.
+ */
+void Database::stopBackups()
+{
+    if (m_backup == 0)
+        return;
+
+    m_backupTimer.stop();
+    m_backup->cancel();
 
-    // Copy the database to the backup.
-    QFile file(getDBname());
-    file.copy(getDBBackupName());
+    m_backupThread.quit();
+    m_backupThread.wait();
+    m_backup = 0;
 }
@@ -23,9 +23,15 @@
 #include <QFile>
 #include <QObject>
 #include <QString>
+#include <QThread>
+#include <QTimer>
 
 class AlbumTable;
+class DatabaseBackup;
 class MediaTable;
+class PhotoEditTable;
+class SearchTable;
+class SqlProfiler;
 
 class QSqlDatabase;
 class QSqlQuery;
@@ -46,10 +52,14 @@ public:
     ~Database();
 
     void logSqlError(QSqlQuery& q) const;
+    bool exec(QSqlQuery& query) const;
+    bool exec(QSqlQuery& query, const QString& statement) const;
     QSqlDatabase* getDB();
 
     AlbumTable* getAlbumTable() const;
     MediaTable* getMediaTable() const;
+    PhotoEditTable* getPhotoEditTable() const;
+    SearchTable* getSearchTable() const;
 
 private:
     bool openDB();
@@ -67,13 +77,20 @@ private:
 
     void restoreFromBackup();
 
-    void createBackup();
+    void startBackups();
+    void stopBackups();
 
     QString m_databaseDirectory;
     QString m_sqlSchemaDirectory;
     QSqlDatabase* m_db;
+    SqlProfiler* m_profiler;
     AlbumTable* m_albumTable;
     MediaTable* m_mediaTable;
+    PhotoEditTable* m_photoEditTable;
+    SearchTable* m_searchTable;
+    DatabaseBackup* m_backup;
+    QThread m_backupThread;
+    QTimer m_backupTimer;
 };
 
 #endif // DATABASE_H
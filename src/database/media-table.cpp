@@ -20,10 +20,36 @@
 #include "media-table.h"
 #include "database.h"
 #include "resource.h"
+#include "search-table.h"
 
 #include <QApplication>
 #include <QtSql>
 
+/*!
+ * \brief splitPath splits an absolute file name into its directory, including
+ * the trailing separator, as stored in the DirectoryTable, and the file name
+ * as stored in the MediaTable
+ * \param filename
+ * \param directory
+ * \param name
+ */
+static void splitPath(const QString& filename, QString* directory, QString* name)
+{
+    int separator = filename.lastIndexOf('/');
+    *directory = filename.left(separator + 1);
+    *name = filename.mid(separator + 1);
+}
+
+/*!
+ * \brief directoryPrefix returns path with a trailing separator
+ * \param path
+ * \return
+ */
+static QString directoryPrefix(const QString& path)
+{
+    return path.endsWith('/') ? path : path + '/';
+}
+
 /*!
  * \brief MediaTable::MediaTable
  * \param db
@@ -34,6 +60,33 @@ MediaTable::MediaTable(Database* db, Resource *resource, QObject* parent)
 {
 }
 
+/*!
+ * \brief MediaTable::getIdForDirectory Returns the row ID for the given
+ * directory, adding a row when the directory isn't known yet.
+ * \param path directory including the trailing separator
+ * \return Returns the row ID for the given directory, or -1 on failure.
+ */
+qint64 MediaTable::getIdForDirectory(const QString& path)
+{
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("SELECT id FROM DirectoryTable WHERE path = :path");
+    query.bindValue(":path", path);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+
+    if (query.next())
+        return query.value(0).toLongLong();
+
+    query.prepare("INSERT INTO DirectoryTable (path) VALUES (:path)");
+    query.bindValue(":path", path);
+    if (!m_db->exec(query)) {
+        m_db->logSqlError(query);
+        return INVALID_ID;
+    }
+
+    return query.lastInsertId().toLongLong();
+}
+
 /*!
  * \brief MediaTable::getIdForMedia Returns the row ID for the given photo.
  * \param filename
@@ -41,11 +94,18 @@ MediaTable::MediaTable(Database* db, Resource *resource, QObject* parent)
  */
 qint64 MediaTable::getIdForMedia(const QString& filename)
 {
+    QString directory;
+    QString name;
+    splitPath(filename, &directory, &name);
+
     // If there's a row for this file, return the ID.
     QSqlQuery query(*m_db->getDB());
-    query.prepare("SELECT id FROM MediaTable WHERE filename = :filename");
-    query.bindValue(":filename", filename);
-    if (!query.exec())
+    query.prepare("SELECT MediaTable.id FROM MediaTable JOIN DirectoryTable "
+                  "ON MediaTable.dir_id = DirectoryTable.id "
+                  "WHERE DirectoryTable.path = :path AND MediaTable.filename = :filename");
+    query.bindValue(":path", directory);
+    query.bindValue(":filename", name);
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
     if (query.next())
@@ -68,22 +128,32 @@ qint64 MediaTable::createIdForMedia(const QString& filename,
                                        const QDateTime& timestamp, const QDateTime& exposureTime,
                                        Orientation originalOrientation, qint64 filesize, QSize size)
 {
+    QString directory;
+    QString name;
+    splitPath(filename, &directory, &name);
+
     // Add the row.
     QSqlQuery query(*m_db->getDB());
-    query.prepare("INSERT INTO MediaTable (filename, timestamp, exposure_time, "
-                  "original_orientation, filesize, width, height) VALUES (:filename, :timestamp, "
-                  ":exposure_time, :original_orientation, :filesize, :width, :height)");
-    query.bindValue(":filename", filename);
+    query.prepare("INSERT INTO MediaTable (dir_id, filename, timestamp, exposure_time, "
+                  "original_orientation, filesize, width, height) VALUES (:dir_id, :filename, "
+                  ":timestamp, :exposure_time, :original_orientation, :filesize, :width, :height)");
+    query.bindValue(":dir_id", getIdForDirectory(directory));
+    query.bindValue(":filename", name);
     query.bindValue(":timestamp", timestamp.toMSecsSinceEpoch());
     query.bindValue(":exposure_time", exposureTime.toMSecsSinceEpoch());
     query.bindValue(":original_orientation", originalOrientation);
     query.bindValue(":filesize", filesize);
     query.bindValue(":width", size.width());
     query.bindValue(":height", size.height());
-    if (!query.exec())
+    bool ok = m_db->exec(query);
+    if (!ok)
         m_db->logSqlError(query);
 
-    return query.lastInsertId().toLongLong();
+    qint64 id = query.lastInsertId().toLongLong();
+    if (ok)
+        m_db->getSearchTable()->indexMedia(id, name, directory);
+
+    return id;
 }
 
 /*!
@@ -99,20 +169,29 @@ void MediaTable::updateMedia(qint64 mediaId, const QString& filename,
                               const QDateTime& timestamp, const QDateTime& exposureTime,
                               Orientation originalOrientation, qint64 filesize)
 {
+    QString directory;
+    QString name;
+    splitPath(filename, &directory, &name);
+
     // Add the row.
     QSqlQuery query(*m_db->getDB());
-    query.prepare("UPDATE MediaTable SET filename = :filename, "
+    query.prepare("UPDATE MediaTable SET dir_id = :dir_id, filename = :filename, "
                   "timestamp = :timestamp, exposure_time = :exposure_time, "
                   "original_orientation = :original_orientation, "
                   "filesize = :filesize WHERE id = :id");
-    query.bindValue(":filename", filename);
+    query.bindValue(":dir_id", getIdForDirectory(directory));
+    query.bindValue(":filename", name);
     query.bindValue(":timestamp", timestamp.toMSecsSinceEpoch());
     query.bindValue(":exposure_time", exposureTime.toMSecsSinceEpoch());
     query.bindValue(":original_orientation", originalOrientation);
     query.bindValue(":filesize", filesize);
     query.bindValue(":id", mediaId);
-    if (!query.exec())
+    if (!m_db->exec(query)) {
         m_db->logSqlError(query);
+        return;
+    }
+
+    m_db->getSearchTable()->indexMedia(mediaId, name, directory);
 }
 
 /*!
@@ -124,8 +203,10 @@ void MediaTable::remove(qint64 mediaId)
     QSqlQuery query(*m_db->getDB());
     query.prepare("DELETE FROM MediaTable WHERE id = :id");
     query.bindValue(":id", mediaId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
+
+    m_db->getSearchTable()->removeMedia(mediaId);
 }
 
 /*!
@@ -138,7 +219,7 @@ QSize MediaTable::getMediaSize(qint64 mediaId)
     QSqlQuery query(*m_db->getDB());
     query.prepare("SELECT width, height FROM MediaTable WHERE id = :id LIMIT 1");
     query.bindValue(":id", mediaId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
     QSize size;
@@ -165,7 +246,7 @@ void MediaTable::setMediaSize(qint64 mediaId, const QSize& size)
     query.bindValue(":id", mediaId);
     query.bindValue(":width", size.width());
     query.bindValue(":height", size.height());
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 }
 
@@ -180,7 +261,7 @@ void MediaTable::setOriginalOrientation(qint64 mediaId, const Orientation& orien
     query.prepare("UPDATE MediaTable SET orientation = :orientation WHERE id = :id");
     query.bindValue(":id", mediaId);
     query.bindValue(":orientation", orientation);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 }
 
@@ -194,7 +275,7 @@ QDateTime MediaTable::getFileTimestamp(qint64 mediaId)
     QSqlQuery query(*m_db->getDB());
     query.prepare("SELECT timestamp FROM MediaTable WHERE id = :id");
     query.bindValue(":id", mediaId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
     QDateTime timestamp;
@@ -215,7 +296,7 @@ QDateTime MediaTable::getExposureTime(qint64 mediaId)
     QSqlQuery query(*m_db->getDB());
     query.prepare("SELECT exposure_time FROM MediaTable WHERE id = :id");
     query.bindValue(":id", mediaId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
     QDateTime exposure_time;
@@ -242,9 +323,9 @@ void MediaTable::removeBlacklistedRows()
     // Expand current regular expressions to use existing external drives
     QStringList replacedRegExpList;
     foreach (const QString& regExp, m_resource->blacklistedDirectories()) {
-        // If regular expression is a valid path add that to the support LIKE format
+        // If regular expression is a valid path use it directly
         if (QDir(regExp).exists()) {
-            replacedRegExpList << regExp + "%";
+            replacedRegExpList << regExp;
             continue;
         }
 
@@ -256,50 +337,62 @@ void MediaTable::removeBlacklistedRows()
             QString replacedRegExp(regExp);
             replacedRegExp.replace("/media/" + qgetenv("USER") + "/[^/]*", "/media/" + qgetenv("USER") + "/" + extDrive);
 
-            if (replacedRegExp.endsWith("/")) {
-                replacedRegExpList << replacedRegExp + "%";
-            } else {
-                replacedRegExpList << replacedRegExp + "/%";
-            }
+            replacedRegExpList << replacedRegExp;
         }
     }
 
-    QSqlQuery query(*m_db->getDB());
-    query.prepare("DELETE FROM MediaTable WHERE filename LIKE :blacklisted");
-
-    foreach (const QString &blacklisted, replacedRegExpList) {
-        query.bindValue(":blacklisted", blacklisted);
-        if (!query.exec()) {
-            m_db->logSqlError(query);
-        }
-    }
+    foreach (const QString &blacklisted, replacedRegExpList)
+        removeDirectoryTree(blacklisted);
 }
 
 /*!
- * \brief MediaTable::emitAllRows goes through the whole DB and emits a row() signal
- * for every single row with all the Database
+ * \brief MediaTable::removeDirectoryTree removes all media in the given
+ * directory and in all of its sub-directories
+ * The directories are selected with a range on the indexed path, and their
+ * media rows go with them through ON DELETE CASCADE.
+ * \param path
  */
-void MediaTable::emitAllRows()
+void MediaTable::removeDirectoryTree(const QString& path)
 {
-    removeBlacklistedRows();
+    QString prefix = directoryPrefix(path);
+
+    // Every path starting with "prefix/" sorts before "prefix0"
+    QString upperBound = prefix;
+    upperBound[upperBound.size() - 1] = QChar('/' + 1);
+
+    // The search index isn't reached by the cascade
+    m_db->getSearchTable()->removeMediaInDirectoryTree(prefix);
 
     QSqlQuery query(*m_db->getDB());
-    query.prepare("SELECT * FROM MediaTable");
-    if (!query.exec())
+    query.prepare("DELETE FROM DirectoryTable WHERE path >= :prefix AND path < :upper");
+    query.bindValue(":prefix", prefix);
+    query.bindValue(":upper", upperBound);
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
+}
 
-    while (query.next()) {
-        qint64 id = query.value(0).toInt();
-        QString filename = query.value(1).toString();
-        QSize size(query.value(2).toInt(), query.value(3).toInt());
-        QDateTime timestamp;
-        timestamp.setMSecsSinceEpoch(query.value(4).toLongLong());
-        QDateTime exposuretime;
-        exposuretime.setMSecsSinceEpoch(query.value(5).toLongLong());
-        Orientation orientation = static_cast<Orientation>(query.value(6).toInt());
-        qint64 filesize = query.value(7).toInt();
-        emit row(id, filename, size, timestamp, exposuretime, orientation, filesize);
-    }
+/*!
+ * \brief MediaTable::allRows opens a cursor on every row of the Database.
+ * Rows come newest exposure time first, which is the default ordering of the
+ * MediaCollection, so receivers can append them without re-sorting.
+ * \return a cursor the caller has to delete
+ */
+MediaRowCursor* MediaTable::allRows()
+{
+    removeBlacklistedRows();
+
+    QSqlQuery* query = new QSqlQuery(*m_db->getDB());
+    query->setForwardOnly(true);
+    query->prepare("SELECT MediaTable.id, "
+                   "IFNULL(DirectoryTable.path, '') || MediaTable.filename, "
+                   "width, height, timestamp, exposure_time, original_orientation, filesize "
+                   "FROM MediaTable LEFT JOIN DirectoryTable "
+                   "ON MediaTable.dir_id = DirectoryTable.id "
+                   "ORDER BY exposure_time DESC");
+    if (!m_db->exec(*query))
+        m_db->logSqlError(*query);
+
+    return new MediaRowCursor(m_db, query);
 }
 
 /*!
@@ -317,7 +410,7 @@ void MediaTable::getRow(qint64 mediaId, QSize& size, Orientation&
     query.prepare("SELECT width, height, timestamp, exposure_time, "
                   "original_orientation FROM MediaTable WHERE id = :id LIMIT 1");
     query.bindValue(":id", mediaId);
-    if (!query.exec())
+    if (!m_db->exec(query))
         m_db->logSqlError(query);
 
     if (!query.next())
@@ -329,3 +422,50 @@ void MediaTable::getRow(qint64 mediaId, QSize& size, Orientation&
     exposureDateTime.setMSecsSinceEpoch(query.value(3).toLongLong());
     originalOrientation = static_cast<Orientation>(query.value(4).toInt());
 }
+
+/*!
+ * \brief MediaRowCursor::MediaRowCursor
+ * \param db
+ * \param query an executed query, the cursor takes ownership of it
+ */
+MediaRowCursor::MediaRowCursor(Database* db, QSqlQuery* query)
+    : m_db(db),
+      m_query(query)
+{
+}
+
+/*!
+ * \brief MediaRowCursor::~MediaRowCursor
+ */
+MediaRowCursor::~MediaRowCursor()
+{
+    delete m_query;
+}
+
+/*!
+ * \brief MediaRowCursor::fetch reads the next rows into an array provided by
+ * the caller. Reusing the same array for every chunk lets the strings and
+ * dates of the previous chunk be overwritten in place.
+ * \param rows the array to fill
+ * \param count the size of rows
+ * \return the number of rows read, 0 once all the rows have been read
+ */
+int MediaRowCursor::fetch(MediaRow* rows, int count)
+{
+    int fetched = 0;
+    while (fetched < count && m_query->next()) {
+        MediaRow& row = rows[fetched++];
+        row.id = m_query->value(0).toLongLong();
+        row.filename = m_query->value(1).toString();
+        row.size = QSize(m_query->value(2).toInt(), m_query->value(3).toInt());
+        row.timestamp.setMSecsSinceEpoch(m_query->value(4).toLongLong());
+        row.exposureTime.setMSecsSinceEpoch(m_query->value(5).toLongLong());
+        row.originalOrientation = static_cast<Orientation>(m_query->value(6).toInt());
+        row.filesize = m_query->value(7).toLongLong();
+    }
+
+    if (fetched < count && m_query->lastError().isValid())
+        m_db->logSqlError(*m_query);
+
+    return fetched;
+}
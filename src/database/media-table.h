@@ -23,11 +23,53 @@
 // util
 #include "orientation.h"
 
+#include <QDateTime>
 #include <QObject>
+#include <QSize>
+#include <QString>
 
 class Database;
 class Resource;
 
+class QSqlQuery;
+
+/*!
+ * \brief The MediaRow struct holds one row of the MediaTable
+ */
+struct MediaRow
+{
+    MediaRow() : id(0), originalOrientation(TOP_LEFT_ORIGIN), filesize(0) {}
+
+    qint64 id;
+    QString filename;
+    QSize size;
+    QDateTime timestamp;
+    QDateTime exposureTime;
+    Orientation originalOrientation;
+    qint64 filesize;
+};
+
+/*!
+ * \brief The MediaRowCursor class walks through the rows of a query on the
+ * MediaTable, a chunk at a time. Get one from MediaTable::allRows().
+ */
+class MediaRowCursor
+{
+public:
+    ~MediaRowCursor();
+
+    int fetch(MediaRow* rows, int count);
+
+private:
+    MediaRowCursor(Database* db, QSqlQuery* query);
+
+    Database* m_db;
+    QSqlQuery* m_query;
+
+    friend class MediaTable;
+    Q_DISABLE_COPY(MediaRowCursor)
+};
+
 /*!
  * \brief The MediaTable class
  */
@@ -63,14 +105,12 @@ public:
     QDateTime getExposureTime(qint64 mediaId);
 
     void removeBlacklistedRows();
-    void emitAllRows();
-
-signals:
-    void row(qint64 mediaId, const QString& filename, const QSize& size,
-             const QDateTime& timestamp, const QDateTime& exposureTime,
-             Orientation originalOrientation, qint64 filesize);
+    void removeDirectoryTree(const QString& path);
+    MediaRowCursor* allRows();
 
 private:
+    qint64 getIdForDirectory(const QString& path);
+
     Database* m_db;
     Resource* m_resource;
 };
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "photo-edit-table.h"
+#include "database.h"
+
+#include <QtSql>
+
+/*!
+ * \brief PhotoEditTable::PhotoEditTable
+ * \param db
+ * \param parent
+ */
+PhotoEditTable::PhotoEditTable(Database* db, QObject* parent)
+    : QObject(parent),
+      m_db(db)
+{
+}
+
+/*!
+ * \brief PhotoEditTable::currentState returns the top of the edit stack
+ * \param mediaId
+ * \return the state of an unedited photo if there are no edits
+ */
+PhotoEditState PhotoEditTable::currentState(qint64 mediaId) const
+{
+    PhotoEditState state;
+
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("SELECT crop_rectangle, is_enhanced, orientation, brightness, "
+                  "contrast, saturation, hue FROM PhotoEditTable "
+                  "WHERE media_id = :media_id ORDER BY step DESC LIMIT 1");
+    query.bindValue(":media_id", mediaId);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+
+    if (query.next()) {
+        state.setCropRectangleFromString(query.value(0).toString());
+        state.isEnhanced = query.value(1).toBool();
+        state.orientation = static_cast<Orientation>(query.value(2).toInt());
+        state.brightness = query.value(3).toDouble();
+        state.contrast = query.value(4).toDouble();
+        state.saturation = query.value(5).toDouble();
+        state.hue = query.value(6).toDouble();
+    }
+
+    return state;
+}
+
+/*!
+ * \brief PhotoEditTable::depth
+ * \param mediaId
+ * \return the number of edits on the stack
+ */
+int PhotoEditTable::depth(qint64 mediaId) const
+{
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("SELECT COUNT(*) FROM PhotoEditTable WHERE media_id = :media_id");
+    query.bindValue(":media_id", mediaId);
+    if (!m_db->exec(query) || !query.next()) {
+        m_db->logSqlError(query);
+        return 0;
+    }
+
+    return query.value(0).toInt();
+}
+
+/*!
+ * \brief PhotoEditTable::push puts a new state on top of the edit stack
+ * \param mediaId
+ * \param state
+ */
+void PhotoEditTable::push(qint64 mediaId, const PhotoEditState& state)
+{
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("INSERT INTO PhotoEditTable (media_id, step, crop_rectangle, "
+                  "is_enhanced, orientation, brightness, contrast, saturation, hue) "
+                  "VALUES (:media_id, (SELECT IFNULL(MAX(step) + 1, 0) FROM "
+                  "PhotoEditTable WHERE media_id = :step_media_id), :crop_rectangle, "
+                  ":is_enhanced, :orientation, :brightness, :contrast, :saturation, :hue)");
+    query.bindValue(":media_id", mediaId);
+    query.bindValue(":step_media_id", mediaId);
+    query.bindValue(":crop_rectangle", state.cropRectangleToString());
+    query.bindValue(":is_enhanced", state.isEnhanced);
+    query.bindValue(":orientation", static_cast<int>(state.orientation));
+    query.bindValue(":brightness", state.brightness);
+    query.bindValue(":contrast", state.contrast);
+    query.bindValue(":saturation", state.saturation);
+    query.bindValue(":hue", state.hue);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+}
+
+/*!
+ * \brief PhotoEditTable::pop removes the top of the edit stack
+ * \param mediaId
+ * \return false if there was no edit to remove
+ */
+bool PhotoEditTable::pop(qint64 mediaId)
+{
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("DELETE FROM PhotoEditTable WHERE rowid = (SELECT rowid FROM "
+                  "PhotoEditTable WHERE media_id = :media_id ORDER BY step DESC LIMIT 1)");
+    query.bindValue(":media_id", mediaId);
+    if (!m_db->exec(query)) {
+        m_db->logSqlError(query);
+        return false;
+    }
+
+    return query.numRowsAffected() > 0;
+}
+
+/*!
+ * \brief PhotoEditTable::clear removes every edit, which reverts the photo to
+ * its original
+ * \param mediaId
+ */
+void PhotoEditTable::clear(qint64 mediaId)
+{
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("DELETE FROM PhotoEditTable WHERE media_id = :media_id");
+    query.bindValue(":media_id", mediaId);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PHOTOEDITTABLE_H
+#define PHOTOEDITTABLE_H
+
+// photo
+#include "photo-edit-state.h"
+
+#include <QObject>
+
+class Database;
+
+/*!
+ * \brief The PhotoEditTable class stores the stack of non-destructive edits of
+ * every photo. Each step of the stack holds the complete PhotoEditState after
+ * that edit, so only the top step is needed to render the photo.
+ */
+class PhotoEditTable : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PhotoEditTable(Database* db, QObject* parent = 0);
+
+    PhotoEditState currentState(qint64 mediaId) const;
+    int depth(qint64 mediaId) const;
+
+    void push(qint64 mediaId, const PhotoEditState& state);
+    bool pop(qint64 mediaId);
+    void clear(qint64 mediaId);
+
+private:
+    Database* m_db;
+};
+
+#endif // PHOTOEDITTABLE_H
@@ -0,0 +1,288 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "search-table.h"
+#include "database.h"
+
+#include <QDebug>
+#include <QStringList>
+#include <QtSql>
+
+/*!
+ * \brief SearchTable::SearchTable
+ * \param db
+ * \param parent
+ */
+SearchTable::SearchTable(Database* db, QObject* parent)
+    : QObject(parent),
+      m_db(db),
+      m_available(false)
+{
+}
+
+/*!
+ * \brief SearchTable::createIndex creates the index tables missing, filled with
+ * the current media and albums, to be called once the schema is up to date.
+ * Without FTS5 they can't be created; searches then find nothing and the index
+ * is left alone.
+ */
+void SearchTable::createIndex()
+{
+    m_available = createTable("MediaSearchTable",
+                              "CREATE VIRTUAL TABLE MediaSearchTable USING fts5("
+                              "filename, folders, prefix = '2 3', "
+                              "tokenize = 'unicode61 remove_diacritics 1')",
+                              "INSERT INTO MediaSearchTable (rowid, filename, folders) "
+                              "SELECT MediaTable.id, MediaTable.filename, "
+                              "IFNULL(DirectoryTable.path, '') FROM MediaTable "
+                              "LEFT JOIN DirectoryTable ON MediaTable.dir_id = DirectoryTable.id")
+            && createTable("AlbumSearchTable",
+                           "CREATE VIRTUAL TABLE AlbumSearchTable USING fts5("
+                           "title, subtitle, prefix = '2 3', "
+                           "tokenize = 'unicode61 remove_diacritics 1')",
+                           "INSERT INTO AlbumSearchTable (rowid, title, subtitle) "
+                           "SELECT id, IFNULL(title, ''), IFNULL(subtitle, '') FROM AlbumTable");
+
+    if (!m_available)
+        qWarning() << "No full-text search index, SQLite may lack FTS5; search is disabled";
+}
+
+/*!
+ * \brief SearchTable::isAvailable
+ * \return false if there is no index to search
+ */
+bool SearchTable::isAvailable() const
+{
+    return m_available;
+}
+
+/*!
+ * \brief SearchTable::indexMedia adds a media to the index, or updates it
+ * \param mediaId
+ * \param filename the name of the file, without directory
+ * \param folders the directory of the file
+ */
+void SearchTable::indexMedia(qint64 mediaId, const QString& filename, const QString& folders)
+{
+    if (!m_available)
+        return;
+
+    removeMedia(mediaId);
+
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("INSERT INTO MediaSearchTable (rowid, filename, folders) "
+                  "VALUES (:id, :filename, :folders)");
+    query.bindValue(":id", mediaId);
+    query.bindValue(":filename", filename);
+    query.bindValue(":folders", folders);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+
+    emit indexChanged();
+}
+
+/*!
+ * \brief SearchTable::removeMedia removes a media from the index
+ * \param mediaId
+ */
+void SearchTable::removeMedia(qint64 mediaId)
+{
+    if (!m_available)
+        return;
+
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("DELETE FROM MediaSearchTable WHERE rowid = :id");
+    query.bindValue(":id", mediaId);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+
+    emit indexChanged();
+}
+
+/*!
+ * \brief SearchTable::removeMediaInDirectoryTree removes all the media below
+ * a directory from the index. Needs to be called before the media are removed
+ * from the MediaTable.
+ * \param prefix the directory, with its trailing separator
+ */
+void SearchTable::removeMediaInDirectoryTree(const QString& prefix)
+{
+    if (!m_available)
+        return;
+
+    // Every path starting with "prefix/" sorts before "prefix0"
+    QString upperBound = prefix;
+    upperBound[upperBound.size() - 1] = QChar('/' + 1);
+
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("DELETE FROM MediaSearchTable WHERE rowid IN "
+                  "(SELECT MediaTable.id FROM MediaTable JOIN DirectoryTable "
+                  "ON MediaTable.dir_id = DirectoryTable.id "
+                  "WHERE DirectoryTable.path >= :prefix AND DirectoryTable.path < :upper)");
+    query.bindValue(":prefix", prefix);
+    query.bindValue(":upper", upperBound);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+
+    emit indexChanged();
+}
+
+/*!
+ * \brief SearchTable::indexAlbum adds an album to the index, or updates it
+ * \param albumId
+ * \param title
+ * \param subtitle
+ */
+void SearchTable::indexAlbum(qint64 albumId, const QString& title, const QString& subtitle)
+{
+    if (!m_available)
+        return;
+
+    removeAlbum(albumId);
+
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("INSERT INTO AlbumSearchTable (rowid, title, subtitle) "
+                  "VALUES (:id, :title, :subtitle)");
+    query.bindValue(":id", albumId);
+    query.bindValue(":title", title);
+    query.bindValue(":subtitle", subtitle);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+
+    emit indexChanged();
+}
+
+/*!
+ * \brief SearchTable::removeAlbum removes an album from the index
+ * \param albumId
+ */
+void SearchTable::removeAlbum(qint64 albumId)
+{
+    if (!m_available)
+        return;
+
+    QSqlQuery query(*m_db->getDB());
+    query.prepare("DELETE FROM AlbumSearchTable WHERE rowid = :id");
+    query.bindValue(":id", albumId);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+
+    emit indexChanged();
+}
+
+/*!
+ * \brief SearchTable::notifyAlbumMediaChanged is called when media are attached
+ * to or detached from an album, as the media of the matching albums are found
+ */
+void SearchTable::notifyAlbumMediaChanged()
+{
+    if (m_available)
+        emit indexChanged();
+}
+
+/*!
+ * \brief SearchTable::search finds the media whose file or folder names match
+ * every word of text, and the media of the albums whose title or subtitle do
+ * \param text what the user typed, every word is used as a prefix
+ * \param mediaIds receives the ids of the matching media
+ */
+void SearchTable::search(const QString& text, QSet<qint64>* mediaIds) const
+{
+    if (!m_available)
+        return;
+
+    QString match = matchExpression(text);
+    if (match.isEmpty())
+        return;
+
+    // UNION ALL saves SQLite a sort, duplicates go away in the QSet
+    QSqlQuery query(*m_db->getDB());
+    query.setForwardOnly(true);
+    query.prepare("SELECT rowid FROM MediaSearchTable WHERE MediaSearchTable MATCH :match "
+                  "UNION ALL "
+                  "SELECT media_id FROM MediaAlbumTable WHERE album_id IN "
+                  "(SELECT rowid FROM AlbumSearchTable WHERE AlbumSearchTable MATCH :album_match)");
+    query.bindValue(":match", match);
+    query.bindValue(":album_match", match);
+    if (!m_db->exec(query))
+        m_db->logSqlError(query);
+
+    while (query.next())
+        mediaIds->insert(query.value(0).toLongLong());
+}
+
+/*!
+ * \brief SearchTable::createTable creates and fills an index table, unless it
+ * exists already, in one transaction
+ * \param name
+ * \param create the statement creating the table
+ * \param fill the statement indexing the existing rows
+ * \return true if the table exists
+ */
+bool SearchTable::createTable(const QString& name, const QString& create,
+                              const QString& fill)
+{
+    QSqlDatabase* db = m_db->getDB();
+    QSqlQuery query(*db);
+    query.prepare("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = :name");
+    query.bindValue(":name", name);
+    if (!m_db->exec(query)) {
+        m_db->logSqlError(query);
+        return false;
+    }
+
+    if (query.next() && query.value(0).toInt() > 0)
+        return true;
+    query.finish();
+
+    if (!db->transaction()) {
+        qWarning() << "Could not start a transaction:" << db->lastError().text();
+        return false;
+    }
+
+    if (!m_db->exec(query, create) || !m_db->exec(query, fill)) {
+        m_db->logSqlError(query);
+        db->rollback();
+        return false;
+    }
+
+    if (!db->commit()) {
+        qWarning() << "Could not create" << name << ":" << db->lastError().text();
+        db->rollback();
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief SearchTable::matchExpression turns what the user typed into an FTS
+ * query matching rows that contain every word as a prefix. The words are
+ * quoted, so nothing the user types is taken as FTS syntax.
+ * \param text
+ * \return an empty string if text has no words
+ */
+QString SearchTable::matchExpression(const QString& text)
+{
+    QStringList terms;
+    foreach (QString word, text.split(QRegExp("\\s+"), QString::SkipEmptyParts)) {
+        word.replace('"', "\"\"");
+        terms.append('"' + word + "\"*");
+    }
+
+    return terms.join(' ');
+}
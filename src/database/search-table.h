@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SEARCHTABLE_H
+#define SEARCHTABLE_H
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class Database;
+
+/*!
+ * \brief The SearchTable class maintains the full-text search index over the
+ * file and folder names of the media, and the titles and subtitles of the
+ * albums. MediaTable and AlbumTable update it as rows come and go.
+ *
+ * The index needs the FTS5 extension of SQLite. It is created outside of the
+ * schema upgrades, so that without FTS5 only the search is lost: searches then
+ * find nothing.
+ */
+class SearchTable : public QObject
+{
+    Q_OBJECT
+
+signals:
+    // fired whenever a search could find something else than before
+    void indexChanged();
+
+public:
+    explicit SearchTable(Database* db, QObject* parent = 0);
+
+    void createIndex();
+    bool isAvailable() const;
+
+    void indexMedia(qint64 mediaId, const QString& filename, const QString& folders);
+    void removeMedia(qint64 mediaId);
+    void removeMediaInDirectoryTree(const QString& prefix);
+
+    void indexAlbum(qint64 albumId, const QString& title, const QString& subtitle);
+    void removeAlbum(qint64 albumId);
+    void notifyAlbumMediaChanged();
+
+    void search(const QString& text, QSet<qint64>* mediaIds) const;
+
+    static QString matchExpression(const QString& text);
+
+private:
+    bool createTable(const QString& name, const QString& create, const QString& fill);
+
+    Database* m_db;
+    bool m_available;
+};
+
+#endif // SEARCHTABLE_H
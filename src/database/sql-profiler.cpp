@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "sql-profiler.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QStringList>
+
+#include <algorithm>
+
+// Statements taking longer than this are logged, in milliseconds
+static const int DEFAULT_SLOW_THRESHOLD = 20;
+
+bool SqlProfiler::m_enabled = false;
+
+/*!
+ * \brief percentile returns the p-th percentile of an ascending list
+ * \param sorted
+ * \param p
+ * \return
+ */
+static qint64 percentile(const QVector<qint64>& sorted, int p)
+{
+    if (sorted.isEmpty())
+        return 0;
+
+    return sorted.at((sorted.size() - 1) * p / 100);
+}
+
+/*!
+ * \brief toMsecs formats a duration given in nanoseconds
+ * \param nsecs
+ * \return
+ */
+static QString toMsecs(qint64 nsecs)
+{
+    return QString::number(nsecs / 1000000.0, 'f', 3) + " ms";
+}
+
+/*!
+ * \brief SqlProfiler::SqlProfiler
+ * \param db the connection used to explain slow statements
+ */
+SqlProfiler::SqlProfiler(QSqlDatabase* db)
+    : m_db(db),
+      m_slowThreshold(DEFAULT_SLOW_THRESHOLD)
+{
+    bool ok = false;
+    int threshold = qgetenv("GALLERY_SLOW_SQL_MS").toInt(&ok);
+    if (ok && threshold >= 0)
+        m_slowThreshold = threshold;
+    m_slowThreshold *= 1000000;
+}
+
+/*!
+ * \brief SqlProfiler::~SqlProfiler prints the summary
+ */
+SqlProfiler::~SqlProfiler()
+{
+    printSummary();
+}
+
+/*!
+ * \brief SqlProfiler::exec executes a prepared query and records its timing
+ * \param query
+ * \return the result of QSqlQuery::exec()
+ */
+bool SqlProfiler::exec(QSqlQuery& query)
+{
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = query.exec();
+    record(query, query.lastQuery(), timer.nsecsElapsed());
+
+    return ok;
+}
+
+/*!
+ * \brief SqlProfiler::exec executes statement and records its timing
+ * \param query
+ * \param statement
+ * \return the result of QSqlQuery::exec()
+ */
+bool SqlProfiler::exec(QSqlQuery& query, const QString& statement)
+{
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = query.exec(statement);
+    record(query, statement, timer.nsecsElapsed());
+
+    return ok;
+}
+
+/*!
+ * \brief SqlProfiler::printSummary prints count, total, p50 and p99 of every
+ * statement run so far, the one taking the most time in total first
+ */
+void SqlProfiler::printSummary() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QList<QPair<qint64, QString> > byTotal;
+    QHash<QString, Timings>::const_iterator it;
+    for (it = m_timings.constBegin(); it != m_timings.constEnd(); ++it)
+        byTotal.append(qMakePair(it.value().total, it.key()));
+    std::sort(byTotal.begin(), byTotal.end());
+
+    qDebug() << "SQL profile:" << byTotal.size() << "statements";
+    for (int i = byTotal.size() - 1; i >= 0; --i) {
+        const Timings& timings = m_timings[byTotal.at(i).second];
+        QVector<qint64> sorted = timings.samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        qDebug() << "  count" << sorted.size()
+                 << "total" << qPrintable(toMsecs(timings.total))
+                 << "p50" << qPrintable(toMsecs(percentile(sorted, 50)))
+                 << "p99" << qPrintable(toMsecs(percentile(sorted, 99)))
+                 << qPrintable(byTotal.at(i).second.simplified());
+    }
+}
+
+/*!
+ * \brief SqlProfiler::setEnabled enables profiling for the Database created
+ * from now on
+ * \param enabled
+ */
+void SqlProfiler::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+/*!
+ * \brief SqlProfiler::isEnabled
+ * \return true if profiling was enabled with setEnabled() or the
+ * GALLERY_PROFILE_SQL environment variable
+ */
+bool SqlProfiler::isEnabled()
+{
+    return m_enabled || !qgetenv("GALLERY_PROFILE_SQL").isEmpty();
+}
+
+/*!
+ * \brief SqlProfiler::record adds a timing for statement and logs it if it is
+ * slow. The query plan is only logged the first time a statement is slow.
+ * \param query
+ * \param statement
+ * \param nsecs
+ */
+void SqlProfiler::record(const QSqlQuery& query, const QString& statement, qint64 nsecs)
+{
+    bool explain = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        Timings& timings = m_timings[statement];
+        timings.samples.append(nsecs);
+        timings.total += nsecs;
+
+        if (nsecs < m_slowThreshold)
+            return;
+
+        explain = !timings.explained;
+        timings.explained = true;
+    }
+
+    qDebug() << "Slow SQL statement" << qPrintable(toMsecs(nsecs))
+             << qPrintable(statement.simplified());
+    if (explain)
+        qDebug() << "  query plan:" << qPrintable(queryPlan(query, statement));
+}
+
+/*!
+ * \brief SqlProfiler::queryPlan runs EXPLAIN QUERY PLAN for statement with the
+ * values bound to query
+ * \param query
+ * \param statement
+ * \return the detail column of the plan, one step per line
+ */
+QString SqlProfiler::queryPlan(const QSqlQuery& query, const QString& statement) const
+{
+    QSqlQuery explain(*m_db);
+    if (!explain.prepare("EXPLAIN QUERY PLAN " + statement))
+        return "unavailable";
+
+    int count = query.boundValues().size();
+    for (int i = 0; i < count; ++i)
+        explain.bindValue(i, query.boundValue(i));
+
+    if (!explain.exec())
+        return "unavailable";
+
+    int detail = explain.record().indexOf("detail");
+    QStringList steps;
+    while (explain.next())
+        steps.append(explain.value(detail).toString());
+
+    return "\n    " + steps.join("\n    ");
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SQL_PROFILER_H
+#define SQL_PROFILER_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+class QSqlDatabase;
+class QSqlQuery;
+
+/*!
+ * \brief The SqlProfiler class times the SQL statements run through the
+ * Database, aggregated per statement text.
+ *
+ * It is opt-in: either pass --profile-sql on the command line or set
+ * GALLERY_PROFILE_SQL in the environment. Statements slower than
+ * GALLERY_SLOW_SQL_MS (20 ms by default) are logged along with their
+ * EXPLAIN QUERY PLAN, and a summary with count, total, p50 and p99 of each
+ * statement is printed when the profiler is destroyed.
+ *
+ * Only the time spent in QSqlQuery::exec() is measured, which for a SELECT
+ * includes producing the first row but not stepping through the others.
+ */
+class SqlProfiler
+{
+public:
+    SqlProfiler(QSqlDatabase* db);
+    ~SqlProfiler();
+
+    bool exec(QSqlQuery& query);
+    bool exec(QSqlQuery& query, const QString& statement);
+
+    void printSummary() const;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+private:
+    struct Timings {
+        Timings() : total(0), explained(false) {}
+
+        QVector<qint64> samples;
+        qint64 total;
+        bool explained;
+    };
+
+    void record(const QSqlQuery& query, const QString& statement, qint64 nsecs);
+    QString queryPlan(const QSqlQuery& query, const QString& statement) const;
+
+    QSqlDatabase* m_db;
+    qint64 m_slowThreshold;
+    mutable QMutex m_mutex;
+    QHash<QString, Timings> m_timings;
+
+    static bool m_enabled;
+};
+
+#endif // SQL_PROFILER_H
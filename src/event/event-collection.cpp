@@ -22,6 +22,7 @@
 
 // core
 #include "data-object.h"
+#include "typed-collection.h"
 
 // media
 #include "media-source.h"
@@ -54,7 +55,7 @@ Event* EventCollection::eventForMediaSource(MediaSource* media) const
 {
     // TODO: Could use lookup table here, but this is fine for now
     Event* event;
-    foreach (event, getAllAsType<Event*>()) {
+    foreach (event, TypedCollection<Event>(this).all()) {
         if (event->contains(media))
             return event;
     }
@@ -89,6 +90,10 @@ void EventCollection::onMediaAddedRemoved(const QSet<DataObject *> *added,
                                            bool notify)
 {
     Event* modifiedEvent = NULL;
+    QSet<Event*> emptied;
+
+    // New and emptied Events are reported as a single change
+    beginBatch();
 
     if (added != NULL) {
         // Split the original QSet into one set for each Event date
@@ -129,13 +134,21 @@ void EventCollection::onMediaAddedRemoved(const QSet<DataObject *> *added,
             event->detach(media, false);
 
             if (event->containedCount() == 0) {
-                destroy(event, true, true);
+                // Deleted once the batch has been reported
+                destroy(event, true, false);
+                emptied.insert(event);
             } else {
             	modifiedEvent = event;
             }
         }
     }
 
+    endBatch();
+
+    if (emptied.contains(modifiedEvent))
+        modifiedEvent = NULL;
+    qDeleteAll(emptied);
+
     if (modifiedEvent != NULL) {
         notifyContentDataChanged(modifiedEvent);
     }
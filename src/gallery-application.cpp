@@ -24,6 +24,9 @@
 #include "album.h"
 #include "album-page.h"
 
+// database
+#include "sql-profiler.h"
+
 // event
 #include "event.h"
 
@@ -43,6 +46,7 @@
 #include "qml-event-collection-model.h"
 #include "qml-event-overview-model.h"
 #include "qml-media-collection-model.h"
+#include "qml-search-model.h"
 
 // util
 #include "command-line-parser.h"
@@ -106,6 +110,9 @@ GalleryApplication::GalleryApplication(int& argc, char** argv)
 
     registerQML();
 
+    if (m_cmdLineParser->profileSql())
+        SqlProfiler::setEnabled(true);
+
     m_galleryManager = new GalleryManager(isDesktopMode(), m_cmdLineParser->picturesDir());
     if (m_cmdLineParser->pickModeEnabled())
         setDefaultUiMode(GalleryApplication::PickContentMode);
@@ -162,9 +169,11 @@ void GalleryApplication::registerQML()
     qmlRegisterType<QmlEventCollectionModel>("Gallery", 1, 0, "EventCollectionModel");
     qmlRegisterType<QmlEventOverviewModel>("Gallery", 1, 0, "EventOverviewModel");
     qmlRegisterType<QmlMediaCollectionModel>("Gallery", 1, 0, "MediaCollectionModel");
+    qmlRegisterType<QmlSearchModel>("Gallery", 1, 0, "SearchModel");
 
     qRegisterMetaType<QList<MediaSource*> >("MediaSourceList");
     qRegisterMetaType<QSet<DataObject*> >("QSet<DataObject*>");
+    qRegisterMetaType<QList<DataObject*> >("QList<DataObject*>");
 }
 
 /*!
@@ -35,6 +35,10 @@
 // media
 #include "media-collection.h"
 #include "media-monitor.h"
+#include "media-prefetcher.h"
+
+// photo
+#include "photo-edit-renderer.h"
 
 // qml
 #include "qml-media-collection-model.h"
@@ -43,10 +47,20 @@
 #include "resource.h"
 
 #include <QApplication>
+#include <QDir>
 #include <QElapsedTimer>
 
 #include <exiv2/exiv2.hpp>
 
+#include <algorithm>
+
+// Time the media collection may be fed for before yielding to the event loop,
+// so the views and models absorbing the media don't make the UI miss a frame
+static const qint64 FEED_FRAME_BUDGET_NS = 4 * 1000 * 1000;
+// Bounds of the number of media added to the collection at once
+static const int FEED_MIN_SLICE_SIZE = 16;
+static const int FEED_MAX_SLICE_SIZE = 4096;
+
 GalleryManager* GalleryManager::m_galleryManager = NULL;
 
 /*!
@@ -64,21 +78,26 @@ GalleryManager::GalleryManager(bool desktopMode,
       m_albumCollection(0),
       m_eventCollection(0),
       m_monitor(0),
+      m_prefetcher(0),
       m_desktopMode(desktopMode),
-      m_objectsReadyToAddTimer(this),
+      m_feedTimer(this),
+      m_feedSliceSize(FEED_MIN_SLICE_SIZE),
+      m_monitorWhenFed(false),
       m_mediaLibrary(0)
 {
     m_mediaFactory = new MediaObjectFactory(m_desktopMode, m_resource);
 
     QObject::connect(m_mediaFactory, SIGNAL(mediaObjectCreated(MediaSource*)),
                      this, SLOT(onMediaObjectCreated(MediaSource*)));
+    QObject::connect(m_mediaFactory, SIGNAL(mediaFromDBChunkLoaded(QList<DataObject *>)),
+                     this, SLOT(onMediaFromDBChunkLoaded(QList<DataObject *>)));
     QObject::connect(m_mediaFactory, SIGNAL(mediaFromDBLoaded(QSet<DataObject *>)),
                      this, SLOT(onMediaFromDBLoaded(QSet<DataObject *>)));
 
-    m_objectsReadyToAddTimer.setSingleShot(true);
-    m_objectsReadyToAddTimer.setInterval(100);
-    QObject::connect(&m_objectsReadyToAddTimer, SIGNAL(timeout()),
-                     this, SLOT(onObjectsReadyToAdd()));
+    m_feedTimer.setSingleShot(true);
+    m_feedTimer.setInterval(0);
+    QObject::connect(&m_feedTimer, SIGNAL(timeout()),
+                     this, SLOT(onFeedMediaCollection()));
 
     m_galleryManager = this;
 }
@@ -89,7 +108,15 @@ GalleryManager::GalleryManager(bool desktopMode,
 GalleryManager::~GalleryManager()
 {
     delete m_monitor;
+    delete m_prefetcher;
     delete m_mediaFactory;
+
+    // never made it into the MediaCollection
+    QList<DataObject *> run;
+    foreach (run, m_mediaToFeed)
+        qDeleteAll(run);
+    qDeleteAll(m_objectsToAdd);
+
     delete m_mediaLibrary;
     delete m_albumCollection;
     delete m_eventCollection;
@@ -140,12 +167,17 @@ void GalleryManager::postInit()
 
         m_database = new Database(m_resource);
         m_mediaFactory->setMediaTable(m_database->getMediaTable());
+        m_mediaFactory->setPhotoEditTable(m_database->getPhotoEditTable());
+        PhotoEditRenderer::setPreviewDirectory(m_resource->thumbnailDirectory() +
+                                               QDir::separator() + "edits");
         m_defaultTemplate = new AlbumDefaultTemplate();
         m_mediaCollection = new MediaCollection(m_database->getMediaTable());
 
         QObject::connect(m_mediaCollection, SIGNAL(collectionChanged()),
                       this, SIGNAL(collectionChanged()));
 
+        m_prefetcher = new MediaPrefetcher();
+
         fillMediaCollection();
 
         collectionsInitialised = true;
@@ -270,33 +302,94 @@ void GalleryManager::onMediaItemRemoved(qint64 mediaId)
  */
 void GalleryManager::onMediaObjectCreated(MediaSource *mediaObject)
 {
-    m_objectsReadyToAddTimer.start(); 
-    if (!m_objectsToAdd.contains(mediaObject)) {
-        m_objectsToAdd.insert(mediaObject);
-    }
+    m_objectsToAdd.insert(mediaObject);
+    m_feedTimer.start();
 }
 
 /*!
- * \brief GalleryManager::onMediaFromDBLoaded
+ * \brief GalleryManager::onMediaFromDBChunkLoaded queues the next run of media
+ * read from the DB; runs arrive already in the collection's order, newest first
+ * \param mediaChunk
+ */
+void GalleryManager::onMediaFromDBChunkLoaded(QList<DataObject *> mediaChunk)
+{
+    feedMediaCollection(mediaChunk);
+}
+
+/*!
+ * \brief GalleryManager::onMediaFromDBLoaded queues the media from the DB that
+ * came out of order. The file monitoring is started once they've all been
+ * added, as its consistency check needs the complete collection.
  * \param mediaFromDB
  */
 void GalleryManager::onMediaFromDBLoaded(QSet<DataObject *> mediaFromDB)
 {
-    m_mediaCollection->addMany(mediaFromDB);
+    QList<DataObject *> media = mediaFromDB.toList();
+    std::sort(media.begin(), media.end(), m_mediaCollection->comparator());
+    feedMediaCollection(media);
     m_mediaFactory->clear();
 
-    startFileMonitoring();
+    m_monitorWhenFed = true;
+    m_feedTimer.start();
 }
 
 /*!
- * \brief GalleryManager::onObjectsReadyToAdd
+ * \brief GalleryManager::feedMediaCollection queues media to be added to the
+ * MediaCollection by onFeedMediaCollection()
+ * \param media sorted like the MediaCollection
  */
-void GalleryManager::onObjectsReadyToAdd()
+void GalleryManager::feedMediaCollection(const QList<DataObject *>& media)
 {
-    if (m_objectsToAdd.isEmpty()) {
+    if (media.isEmpty())
         return;
+
+    m_mediaToFeed.append(media);
+    m_feedTimer.start();
+}
+
+/*!
+ * \brief GalleryManager::onFeedMediaCollection adds the queued media to the
+ * MediaCollection in slices, in the order they were queued, for as long as the
+ * frame budget allows, and then yields to the event loop until the next turn.
+ * The size of the slices follows how long the last one took to be absorbed by
+ * the collection and everything monitoring it.
+ */
+void GalleryManager::onFeedMediaCollection()
+{
+    if (!m_objectsToAdd.isEmpty()) {
+        QList<DataObject *> media = m_objectsToAdd.toList();
+        m_objectsToAdd.clear();
+        std::sort(media.begin(), media.end(), m_mediaCollection->comparator());
+        m_mediaToFeed.append(media);
     }
 
-    m_mediaCollection->addMany(m_objectsToAdd);
-    m_objectsToAdd.clear();
+    QElapsedTimer frame;
+    frame.start();
+    while (!m_mediaToFeed.isEmpty() && frame.nsecsElapsed() < FEED_FRAME_BUDGET_NS) {
+        QList<DataObject *>& run = m_mediaToFeed.first();
+        int count = qMin(m_feedSliceSize, run.count());
+        QList<DataObject *> slice = run.mid(0, count);
+        run.erase(run.begin(), run.begin() + count);
+        if (run.isEmpty())
+            m_mediaToFeed.removeFirst();
+
+        QElapsedTimer timer;
+        timer.start();
+        m_mediaCollection->appendSorted(slice);
+        qint64 elapsed = timer.nsecsElapsed();
+
+        // aim for a few slices per frame
+        if (count == m_feedSliceSize) {
+            qint64 size = count * (FEED_FRAME_BUDGET_NS / 4) / qMax(elapsed, (qint64) 1);
+            m_feedSliceSize = (int) qBound((qint64) FEED_MIN_SLICE_SIZE, size,
+                                           (qint64) FEED_MAX_SLICE_SIZE);
+        }
+    }
+
+    if (!m_mediaToFeed.isEmpty()) {
+        m_feedTimer.start();
+    } else if (m_monitorWhenFed) {
+        m_monitorWhenFed = false;
+        startFileMonitoring();
+    }
 }
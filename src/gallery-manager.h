@@ -39,6 +39,7 @@ class GalleryManager;
 class MediaCollection;
 class MediaMonitor;
 class MediaObjectFactory;
+class MediaPrefetcher;
 class QmlMediaCollectionModel;
 class Resource;
 
@@ -64,6 +65,7 @@ public:
     MediaCollection *mediaCollection() { return m_mediaCollection; }
     AlbumCollection *albumCollection();
     EventCollection *eventCollection();
+    MediaPrefetcher *prefetcher() { return m_prefetcher; }
     Resource *resource() { return m_resource; }
 
     void logImageLoading(bool log);
@@ -79,8 +81,9 @@ private slots:
     void onMediaItemAdded(QString file, int priority);
     void onMediaItemRemoved(qint64 mediaId);
     void onMediaObjectCreated(MediaSource *mediaObject);
+    void onMediaFromDBChunkLoaded(QList<DataObject *> mediaChunk);
     void onMediaFromDBLoaded(QSet<DataObject *> mediaFromDB);
-    void onObjectsReadyToAdd();
+    void onFeedMediaCollection();
 
 private:
     GalleryManager(const GalleryManager&);
@@ -88,6 +91,7 @@ private:
 
     void fillMediaCollection();
     void startFileMonitoring();
+    void feedMediaCollection(const QList<DataObject*>& media);
 
     static GalleryManager* m_galleryManager;
 
@@ -101,9 +105,14 @@ private:
     EventCollection* m_eventCollection;
     MediaObjectFactory *m_mediaFactory;
     MediaMonitor *m_monitor;
+    MediaPrefetcher *m_prefetcher;
     bool m_desktopMode;
-    QTimer m_objectsReadyToAddTimer;
+    QTimer m_feedTimer;
     QSet<DataObject *> m_objectsToAdd;
+    // Runs of media sorted like the MediaCollection, waiting to be added to it
+    QList<QList<DataObject *> > m_mediaToFeed;
+    int m_feedSliceSize;
+    bool m_monitorWhenFed;
 
     mutable QmlMediaCollectionModel *m_mediaLibrary;
 };
@@ -31,6 +31,12 @@
 #include <video.h>
 
 #include <QApplication>
+#include <QVector>
+
+// Size of the first chunk of media handed over while loading from the DB; it
+// is doubled for each chunk after that, up to the maximum.
+static const int MEDIA_FROM_DB_FIRST_CHUNK_SIZE = 64;
+static const int MEDIA_FROM_DB_MAX_CHUNK_SIZE = 2048;
 
 QWaitCondition listNotEmptyCondition;
 QMutex createMutex;
@@ -51,6 +57,8 @@ MediaObjectFactory::MediaObjectFactory(bool desktopMode, Resource *res)
     
     QObject::connect(m_worker, SIGNAL(mediaObjectCreated(MediaSource*)),
                      this, SIGNAL(mediaObjectCreated(MediaSource*)), Qt::QueuedConnection);
+    QObject::connect(m_worker, SIGNAL(mediaFromDBChunkLoaded(QList<DataObject *>)),
+                     this, SIGNAL(mediaFromDBChunkLoaded(QList<DataObject *>)), Qt::QueuedConnection);
     QObject::connect(m_worker, SIGNAL(mediaFromDBLoaded(QSet<DataObject *>)),
                      this, SIGNAL(mediaFromDBLoaded(QSet<DataObject *>)), Qt::QueuedConnection);
 
@@ -72,6 +80,15 @@ void MediaObjectFactory::setMediaTable(MediaTable *mediaTable)
     m_worker->setMediaTable(mediaTable);
 }
 
+/*!
+ * \brief MediaObjectFactory::setPhotoEditTable
+ * \param photoEditTable
+ */
+void MediaObjectFactory::setPhotoEditTable(PhotoEditTable *photoEditTable)
+{
+    m_worker->setPhotoEditTable(photoEditTable);
+}
+
 /*!
  * \brief GalleryManager::enableContentLoadFilter enable filter to load only
  * content of certain type
@@ -106,9 +123,12 @@ void MediaObjectFactory::create(const QFileInfo &file, int priority, bool deskto
 }
 
 /*!
- * \brief MediaObjectFactory::loadMediaFromDB creates a set with all photos and video
+ * \brief MediaObjectFactory::loadMediaFromDB creates all photos and video
  * stored in the DB.
- * Someone else needs to take the responsibility to delete all the objects in the set.
+ * They are handed over newest first in chunks through mediaFromDBChunkLoaded(),
+ * each chunk sorted by descending exposure time, followed by
+ * mediaFromDBLoaded() with whatever could not be delivered in order.
+ * Someone else needs to take the responsibility to delete all the objects.
  * You should call clear() afterwards, to remove temporary data.
  * \return All media stored in the DB
  */
@@ -131,7 +151,9 @@ void MediaObjectFactory::enqueuePath(const QString &path, int priority)
 MediaObjectFactoryWorker::MediaObjectFactoryWorker(QObject *parent)
     : QObject(parent),
       m_mediaTable(),
-      m_filterType(MediaSource::None)
+      m_photoEditTable(0),
+      m_filterType(MediaSource::None),
+      m_mediaFromDBChunkSize(MEDIA_FROM_DB_FIRST_CHUNK_SIZE)
 {
 }
 
@@ -163,6 +185,11 @@ void MediaObjectFactoryWorker::setMediaTable(MediaTable *mediaTable)
     m_mediaTable = mediaTable;
 }
 
+void MediaObjectFactoryWorker::setPhotoEditTable(PhotoEditTable *photoEditTable)
+{
+    m_photoEditTable = photoEditTable;
+}
+
 void MediaObjectFactoryWorker::enableContentLoadFilter(MediaSource::MediaType filterType)
 {
     m_filterType = filterType;
@@ -171,6 +198,7 @@ void MediaObjectFactoryWorker::enableContentLoadFilter(MediaSource::MediaType fi
 void MediaObjectFactoryWorker::clear()
 {
     clearMetadata();
+    m_mediaFromDBChunk.clear();
     m_mediaFromDB.clear();
 }
 
@@ -203,6 +231,7 @@ void MediaObjectFactoryWorker::create(const QString &path)
     Photo *photo = 0;
     if (mediaType == MediaSource::Photo) {
         photo = new Photo(file);
+        photo->setPhotoEditTable(m_photoEditTable);
         media = photo;
     } else {
         media = new Video(file);
@@ -245,21 +274,38 @@ void MediaObjectFactoryWorker::mediaFromDB()
 {
     Q_ASSERT(m_mediaTable);
 
+    m_mediaFromDBChunk.clear();
+    m_mediaFromDBChunkSize = MEDIA_FROM_DB_FIRST_CHUNK_SIZE;
+    m_lastExposureTime = QDateTime();
     m_mediaFromDB.clear();
 
-    connect(m_mediaTable,
-            SIGNAL(row(qint64,QString,QSize,QDateTime,QDateTime,Orientation,qint64)),
-            this,
-            SLOT(addMedia(qint64,QString,QSize,QDateTime,QDateTime,Orientation,qint64)));
+    // One chunk worth of rows is read at a time, into the same array
+    MediaRowCursor* cursor = m_mediaTable->allRows();
+    QVector<MediaRow> rows(MEDIA_FROM_DB_MAX_CHUNK_SIZE);
+    int count;
+    while ((count = cursor->fetch(rows.data(), m_mediaFromDBChunkSize)) > 0) {
+        for (int i = 0; i < count; ++i)
+            addMedia(rows.at(i));
+    }
+    delete cursor;
 
-    m_mediaTable->emitAllRows();
+    flushMediaFromDBChunk();
+    emit mediaFromDBLoaded(m_mediaFromDB);
+}
 
-    disconnect(m_mediaTable,
-               SIGNAL(row(qint64,QString,QSize,QDateTime,QDateTime,Orientation,qint64)),
-               this,
-               SLOT(addMedia(qint64,QString,QSize,QDateTime,QDateTime,Orientation,qint64)));
+/*!
+ * \brief MediaObjectFactoryWorker::flushMediaFromDBChunk hands the media
+ * collected so far over to the main thread, and grows the next chunk
+ */
+void MediaObjectFactoryWorker::flushMediaFromDBChunk()
+{
+    if (m_mediaFromDBChunk.isEmpty())
+        return;
 
-    emit mediaFromDBLoaded(m_mediaFromDB);
+    emit mediaFromDBChunkLoaded(m_mediaFromDBChunk);
+    m_mediaFromDBChunk.clear();
+
+    m_mediaFromDBChunkSize = qMin(m_mediaFromDBChunkSize * 2, MEDIA_FROM_DB_MAX_CHUNK_SIZE);
 }
 
 /*!
@@ -342,26 +388,16 @@ bool MediaObjectFactoryWorker::readVideoMetadata(const QFileInfo &file)
 
 /*!
  * \brief MediaObjectFactory::addMedia creates a media object, and adds it to the
- * internal set. This is used for mediaFromDB().
- * \param mediaId
- * \param filename
- * \param size
- * \param timestamp
- * \param exposureTime
- * \param originalOrientation
- * \param filesize
- * \return
+ * current chunk. This is used for mediaFromDB().
+ * Rows are expected by descending exposure time; a row that breaks that order
+ * is kept aside and delivered with mediaFromDBLoaded() instead.
+ * \param row
  */
-void MediaObjectFactoryWorker::addMedia(qint64 mediaId, const QString &filename,
-                                  const QSize &size, const QDateTime &timestamp,
-                                  const QDateTime &exposureTime,
-                                  Orientation originalOrientation, qint64 filesize)
+void MediaObjectFactoryWorker::addMedia(const MediaRow& row)
 {
-    Q_UNUSED(filesize);
-
-    QFileInfo file(filename);
+    QFileInfo file(row.filename);
     if (!file.exists()) {
-        m_mediaTable->remove(mediaId);
+        m_mediaTable->remove(row.id);
         return;
     }
 
@@ -373,20 +409,30 @@ void MediaObjectFactoryWorker::addMedia(qint64 mediaId, const QString &filename,
     Photo *photo = 0;
     if (mediaType == MediaSource::Photo) {
         photo = new Photo(file);
+        photo->setPhotoEditTable(m_photoEditTable);
         media = photo;
     } else {
         media = new Video(file);
     }
     media->setMediaTable(m_mediaTable);
 
-    media->setSize(size);
-    media->setFileTimestamp(timestamp);
-    media->setExposureDateTime(exposureTime);
+    media->setSize(row.size);
+    media->setFileTimestamp(row.timestamp);
+    media->setExposureDateTime(row.exposureTime);
     if (mediaType == MediaSource::Photo) {
-        photo->setOriginalOrientation(originalOrientation);
+        photo->setOriginalOrientation(row.originalOrientation);
     }
-    media->setId(mediaId);
+    media->setId(row.id);
 
     media->moveToThread(QApplication::instance()->thread());
-    m_mediaFromDB.insert(media);
+
+    if (m_lastExposureTime.isValid() && row.exposureTime > m_lastExposureTime) {
+        m_mediaFromDB.insert(media);
+        return;
+    }
+
+    m_lastExposureTime = row.exposureTime;
+    m_mediaFromDBChunk.append(media);
+    if (m_mediaFromDBChunk.count() >= m_mediaFromDBChunkSize)
+        flushMediaFromDBChunk();
 }
@@ -32,6 +32,8 @@
 
 class MediaTable;
 class MediaObjectFactoryWorker;
+class PhotoEditTable;
+struct MediaRow;
 
 /*!
  * \brief The MediaObjectFactory creates phot and video objects
@@ -45,6 +47,7 @@ public:
     virtual ~MediaObjectFactory();
 
     void setMediaTable(MediaTable *mediaTable);
+    void setPhotoEditTable(PhotoEditTable *photoEditTable);
     void enableContentLoadFilter(MediaSource::MediaType filterType);
     void clear();
     void create(const QFileInfo& file, int priority, bool desktopMode, Resource *res);
@@ -52,6 +55,7 @@ public:
 
 signals:
     void mediaObjectCreated(MediaSource *newMediaObject);
+    void mediaFromDBChunkLoaded(QList<DataObject *> mediaChunk);
     void mediaFromDBLoaded(QSet<DataObject *> mediaFromDB);
 
 private:    
@@ -77,6 +81,7 @@ public:
 public slots:
     void runCreate();
     void setMediaTable(MediaTable *mediaTable);
+    void setPhotoEditTable(PhotoEditTable *photoEditTable);
     void enableContentLoadFilter(MediaSource::MediaType filterType);
     void clear();
     void create(const QString& path);
@@ -84,19 +89,18 @@ public slots:
 
 signals:
     void mediaObjectCreated(MediaSource *newMediaObject);
+    void mediaFromDBChunkLoaded(QList<DataObject *> mediaChunk);
     void mediaFromDBLoaded(QSet<DataObject *> mediaFromDB);
 
-private slots:
-    void addMedia(qint64 mediaId, const QString& filename, const QSize& size,
-                  const QDateTime& timestamp, const QDateTime& exposureTime,
-                  Orientation originalOrientation, qint64 filesize);
-
 private:
+    void addMedia(const MediaRow& row);
     void clearMetadata();
     bool readPhotoMetadata(const QFileInfo &file);
     bool readVideoMetadata(const QFileInfo &file);
+    void flushMediaFromDBChunk();
 
     MediaTable *m_mediaTable;
+    PhotoEditTable *m_photoEditTable;
     MediaSource::MediaType m_filterType;
     QDateTime m_timeStamp;
     QDateTime m_exposureTime;
@@ -104,6 +108,11 @@ private:
     qint64 m_fileSize;
     QSize m_size;
 
+    // Media read from the DB in the collection's order, not yet handed over
+    QList<DataObject*> m_mediaFromDBChunk;
+    int m_mediaFromDBChunkSize;
+    QDateTime m_lastExposureTime;
+    // Media read from the DB out of order, handed over at the end
     QSet<DataObject*> m_mediaFromDB;
 
     friend class tst_MediaObjectFactory;
@@ -28,6 +28,16 @@
 #include <QString>
 #include <QStringList>
 
+static const bool sortKeysRegistered =
+        DataCollection::registerSortKey(MediaCollection::exposureDateTimeAscendingComparator,
+                                        MediaCollection::exposureDateTimeAscendingKey)
+        && DataCollection::registerSortKey(MediaCollection::exposureDateTimeDescendingComparator,
+                                           MediaCollection::exposureDateTimeDescendingKey);
+
+static const bool inverseComparatorsRegistered =
+        DataCollection::registerInverseComparators(MediaCollection::exposureDateTimeAscendingComparator,
+                                                   MediaCollection::exposureDateTimeDescendingComparator);
+
 /*!
  * \brief MediaCollection::MediaCollection
  * \param directory
@@ -53,12 +63,7 @@ MediaCollection::MediaCollection(MediaTable *mediaTable)
 bool MediaCollection::exposureDateTimeAscendingComparator(DataObject* a,
                                                           DataObject* b)
 {
-    const QDateTime &exptime_a = qobject_cast<MediaSource*>(a)->exposureDateTime();
-    const QDateTime &exptime_b = qobject_cast<MediaSource*>(b)->exposureDateTime();
-
-    return (exptime_a == exptime_b) ?
-                (!DataCollection::defaultDataObjectComparator(a, b)) :
-                (exptime_a < exptime_b);
+    return exposureDateTimeAscendingKey(a) < exposureDateTimeAscendingKey(b);
 }
 
 /*!
@@ -70,7 +75,32 @@ bool MediaCollection::exposureDateTimeAscendingComparator(DataObject* a,
 bool MediaCollection::exposureDateTimeDescendingComparator(DataObject* a,
                                                            DataObject* b)
 {
-    return !exposureDateTimeAscendingComparator(a, b);
+    return exposureDateTimeDescendingKey(a) < exposureDateTimeDescendingKey(b);
+}
+
+/*!
+ * \brief MediaCollection::exposureDateTimeAscendingKey
+ * Media taken at the same time are ordered by descending DataObjectNumber,
+ * so this is the exact reverse of exposureDateTimeDescendingKey()
+ * \param object
+ * \return
+ */
+DataObjectKey MediaCollection::exposureDateTimeAscendingKey(DataObject* object)
+{
+    MediaSource* media = qobject_cast<MediaSource*>(object);
+    return DataObjectKey(media->exposureDateTime().toMSecsSinceEpoch(), -object->number());
+}
+
+/*!
+ * \brief MediaCollection::exposureDateTimeDescendingKey
+ * Media taken at the same time are ordered by ascending DataObjectNumber
+ * \param object
+ * \return
+ */
+DataObjectKey MediaCollection::exposureDateTimeDescendingKey(DataObject* object)
+{
+    MediaSource* media = qobject_cast<MediaSource*>(object);
+    return DataObjectKey(-media->exposureDateTime().toMSecsSinceEpoch(), object->number());
 }
 
 /*!
@@ -106,6 +136,8 @@ void MediaCollection::notifyContentsChanged(const QSet<DataObject*>* added,
                 m_fileMediaMap.insert(media->file().absoluteFilePath(), media);
                 QObject::connect(media, SIGNAL(busyChanged(bool)),
                                  this, SIGNAL(mediaIsBusy(bool)));
+                QObject::connect(media, SIGNAL(dataChanged()),
+                                 this, SLOT(onMediaDataChanged()));
             }
         }
     }
@@ -120,6 +152,7 @@ void MediaCollection::notifyContentsChanged(const QSet<DataObject*>* added,
                 m_fileMediaMap.remove(media->file().absoluteFilePath());
                 QObject::disconnect(media, SIGNAL(busyChanged(bool)),
                                     this, SIGNAL(mediaIsBusy(bool)));
+                QObject::disconnect(media, 0, this, SLOT(onMediaDataChanged()));
             }
 
             m_idMap.remove(media->id());
@@ -214,3 +247,14 @@ void MediaCollection::destroy(qint64 id, bool destroy_backing)
         SourceCollection::destroy(media, destroy_backing, true);
     }
 }
+
+/*!
+ * \brief MediaCollection::onMediaDataChanged reports a change to the data of
+ * one of the media, such as an edit, as a contentDataChanged()
+ */
+void MediaCollection::onMediaDataChanged()
+{
+    MediaSource* media = qobject_cast<MediaSource*>(sender());
+    if (media != NULL && contains(media))
+        notifyContentDataChanged(media);
+}
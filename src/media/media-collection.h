@@ -43,6 +43,8 @@ public:
 
     static bool exposureDateTimeAscendingComparator(DataObject* a, DataObject* b);
     static bool exposureDateTimeDescendingComparator(DataObject* a, DataObject* b);
+    static DataObjectKey exposureDateTimeAscendingKey(DataObject* object);
+    static DataObjectKey exposureDateTimeDescendingKey(DataObject* object);
 
     MediaSource* mediaForId(qint64 id);
     const MediaSource* mediaFromFileinfo(const QFileInfo &file) const;
@@ -63,6 +65,9 @@ protected slots:
                                        const QSet<DataObject*>* removed,
                                        bool notify);
 
+private slots:
+    void onMediaDataChanged();
+
 private:
     // Used by photoFromFileinfo() to prevent ourselves from accidentally
     // seeing a duplicate photo after an edit.
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "media-prefetcher.h"
+#include "media-source.h"
+
+#include <QImageReader>
+
+/*!
+ * \brief MediaPrefetcher::MediaPrefetcher
+ */
+MediaPrefetcher::MediaPrefetcher(QObject *parent)
+    : QObject(parent),
+      m_workerThread(this),
+      m_probing(false)
+{
+    m_worker = new MediaPrefetcherWorker();
+    m_worker->moveToThread(&m_workerThread);
+    QObject::connect(&m_workerThread, SIGNAL(finished()),
+                     m_worker, SLOT(deleteLater()));
+
+    QObject::connect(m_worker, SIGNAL(sizeProbed(QString, QSize)),
+                     this, SLOT(onSizeProbed(QString, QSize)), Qt::QueuedConnection);
+
+    m_workerThread.start(QThread::LowPriority);
+}
+
+/*!
+ * \brief MediaPrefetcher::~MediaPrefetcher
+ */
+MediaPrefetcher::~MediaPrefetcher()
+{
+    m_workerThread.quit();
+    m_workerThread.wait();
+}
+
+/*!
+ * \brief MediaPrefetcher::setQueue replaces the media of the owner waiting to be
+ * prefetched, which then come before those of the other owners. The one being
+ * prefetched already is finished.
+ * \param owner
+ * \param media most wanted first
+ */
+void MediaPrefetcher::setQueue(QObject* owner, const QList<MediaSource*>& media)
+{
+    QList<QPointer<MediaSource> > queue;
+    MediaSource* source;
+    foreach (source, media) {
+        if (needsPrefetch(source))
+            queue.append(source);
+    }
+
+    if (!m_queues.contains(owner)) {
+        QObject::connect(owner, SIGNAL(destroyed(QObject*)),
+                         this, SLOT(onOwnerDestroyed(QObject*)));
+    }
+
+    m_queues.insert(owner, queue);
+    m_owners.removeOne(owner);
+    m_owners.prepend(owner);
+
+    if (!m_probing)
+        prefetchNext();
+}
+
+/*!
+ * \brief MediaPrefetcher::onSizeProbed sets the size of the media prefetched,
+ * as shown
+ * \param path
+ * \param size the size stored in the file, invalid if it couldn't be read
+ */
+void MediaPrefetcher::onSizeProbed(const QString& path, const QSize& size)
+{
+    MediaSource* media = m_prefetching.data();
+    m_prefetching.clear();
+    m_probing = false;
+
+    if (media != NULL && media->file().absoluteFilePath() == path && size.isValid()) {
+        switch (media->orientation()) {
+        case LEFT_TOP_ORIGIN:
+        case RIGHT_TOP_ORIGIN:
+        case RIGHT_BOTTOM_ORIGIN:
+        case LEFT_BOTTOM_ORIGIN:
+            media->setSize(size.transposed());
+            break;
+
+        default:
+            media->setSize(size);
+            break;
+        }
+    }
+
+    prefetchNext();
+}
+
+/*!
+ * \brief MediaPrefetcher::onOwnerDestroyed drops the queue of the owner
+ * \param owner
+ */
+void MediaPrefetcher::onOwnerDestroyed(QObject* owner)
+{
+    m_queues.remove(owner);
+    m_owners.removeOne(owner);
+}
+
+/*!
+ * \brief MediaPrefetcher::needsPrefetch
+ * \param media
+ * \return true if the media is a photo whose size isn't known yet
+ */
+bool MediaPrefetcher::needsPrefetch(MediaSource* media) const
+{
+    return media != NULL && media->type() == MediaSource::Photo && !media->isSizeSet();
+}
+
+/*!
+ * \brief MediaPrefetcher::prefetchNext hands the first media still needing it
+ * to the worker, from the queue updated last that has any
+ */
+void MediaPrefetcher::prefetchNext()
+{
+    QObject* owner;
+    foreach (owner, m_owners) {
+        QList<QPointer<MediaSource> >& queue = m_queues[owner];
+        while (!queue.isEmpty()) {
+            MediaSource* media = queue.takeFirst().data();
+            if (!needsPrefetch(media))
+                continue;
+
+            m_prefetching = media;
+            m_probing = true;
+            QMetaObject::invokeMethod(m_worker, "probeSize", Qt::QueuedConnection,
+                                      Q_ARG(QString, media->file().absoluteFilePath()));
+            return;
+        }
+    }
+}
+
+/*!
+ * \brief MediaPrefetcherWorker::MediaPrefetcherWorker
+ */
+MediaPrefetcherWorker::MediaPrefetcherWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+/*!
+ * \brief MediaPrefetcherWorker::probeSize reads the size of an image from the
+ * header of its file, without decoding it
+ * \param path
+ */
+void MediaPrefetcherWorker::probeSize(const QString& path)
+{
+    QImageReader reader(path);
+
+    emit sizeProbed(path, reader.size());
+}
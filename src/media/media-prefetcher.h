@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GALLERY_MEDIA_PREFETCHER_H_
+#define GALLERY_MEDIA_PREFETCHER_H_
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QSize>
+#include <QString>
+#include <QThread>
+
+class MediaPrefetcherWorker;
+class MediaSource;
+
+/*!
+ * \brief The MediaPrefetcher class gets data of the media ahead of being shown,
+ * for now the size of photos not known yet, read from the file headers.
+ * Each owner, such as a model, has a queue of media, most wanted first;
+ * replacing it drops the work no longer needed. The media are taken one at a
+ * time from the queue updated last, and their files read in an extra thread.
+ */
+class MediaPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    MediaPrefetcher(QObject *parent=0);
+    virtual ~MediaPrefetcher();
+
+    void setQueue(QObject* owner, const QList<MediaSource*>& media);
+
+private slots:
+    void onSizeProbed(const QString& path, const QSize& size);
+    void onOwnerDestroyed(QObject* owner);
+
+private:
+    bool needsPrefetch(MediaSource* media) const;
+    void prefetchNext();
+
+    MediaPrefetcherWorker* m_worker;
+    QThread m_workerThread;
+    QHash<QObject*, QList<QPointer<MediaSource> > > m_queues;
+    // The owners of the queues, the one updated last first
+    QList<QObject*> m_owners;
+    QPointer<MediaSource> m_prefetching;
+    // Whether the worker is probing a file, even if its media is gone since
+    bool m_probing;
+};
+
+
+/*!
+ * \brief The MediaPrefetcherWorker class reads the files for the
+ * MediaPrefetcher, and is supposed to live in its thread
+ */
+class MediaPrefetcherWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    MediaPrefetcherWorker(QObject *parent=0);
+
+public slots:
+    void probeSize(const QString& path);
+
+signals:
+    void sizeProbed(const QString& path, const QSize& size);
+};
+
+#endif // GALLERY_MEDIA_PREFETCHER_H_
@@ -47,6 +47,7 @@ MediaSource::MediaSource(const QFileInfo& file)
       m_mediaTable(0)
 {
     m_file = file;
+    m_path = QUrl::fromLocalFile(m_file.absoluteFilePath());
 }
 
 /*!
@@ -73,7 +74,7 @@ QFileInfo MediaSource::file() const
  */
 QUrl MediaSource::path() const
 {
-    return QUrl::fromLocalFile(m_file.absoluteFilePath());
+    return m_path;
 }
 
 /*!
@@ -95,6 +95,7 @@ public:
     void setFileTimestamp(const QDateTime& timestamp);
 
     const QSize& size();
+    bool isSizeSet() const;
 
     qint64 id() const;
     void setId(qint64 id);
@@ -109,8 +110,6 @@ public Q_SLOTS:
     void setSize(const QSize& size);
 
 protected:
-    bool isSizeSet() const;
-
     virtual void destroySource(bool deleteBacking, bool asOrphan);
 
     virtual void notifyDataChanged();
@@ -128,6 +127,7 @@ private:
     }
 
     QFileInfo m_file;
+    QUrl m_path;
     qint64 m_id;
     QSize m_size;
     QDateTime m_exposureDateTime;
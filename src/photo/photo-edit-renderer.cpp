@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "photo-edit-renderer.h"
+#include "photo-edit-state.h"
+
+// util
+#include "imaging.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QStringList>
+
+// JPEG quality of the cached previews
+static const int PREVIEW_QUALITY = 90;
+
+QString PhotoEditRenderer::m_previewDirectory;
+
+/*!
+ * \brief transformPixels runs every pixel of an RGB32 image through
+ * transformation
+ * \param image
+ * \param transformation an AutoEnhanceTransformation or a ColorBalance
+ */
+template <class Transformation>
+static void transformPixels(QImage* image, const Transformation& transformation)
+{
+    for (int y = 0; y < image->height(); ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(image->scanLine(y));
+        for (int x = 0; x < image->width(); ++x)
+            line[x] = transformation.transformPixel(QColor(line[x])).rgb();
+    }
+}
+
+/*!
+ * \brief PhotoEditRenderer::render renders the edits of a photo
+ * \param fileName the original file
+ * \param fileOrientation the orientation stored in the file, used unless the
+ * edits rotate the photo
+ * \param state the edits
+ * \param maxSize the result is scaled down to fit in it, an invalid size keeps
+ * the original resolution
+ * \return the rendered image, a null image if the file couldn't be read
+ */
+QImage PhotoEditRenderer::render(const QString& fileName, Orientation fileOrientation,
+                                 const PhotoEditState& state, const QSize& maxSize)
+{
+    QImageReader reader(fileName);
+
+    QRect fullRect(QPoint(0, 0), reader.size());
+    QRect clip = fullRect;
+    if (!state.cropRectangle.isNull() && fullRect.isValid()) {
+        clip = state.cropRectangle.intersected(fullRect);
+        if (clip.isEmpty())
+            clip = fullRect;
+    }
+
+    Orientation orientation = state.orientation != NO_ORIENTATION ?
+                state.orientation : fileOrientation;
+    // Orientations from LEFT_TOP_ORIGIN on swap width and height
+    bool transposed = orientation >= LEFT_TOP_ORIGIN;
+
+    if (clip.isValid()) {
+        if (clip != fullRect)
+            reader.setClipRect(clip);
+
+        QSize size = transposed ? clip.size().transposed() : clip.size();
+        if (maxSize.isValid() &&
+                (size.width() > maxSize.width() || size.height() > maxSize.height())) {
+            size.scale(maxSize, Qt::KeepAspectRatio);
+            reader.setScaledSize(transposed ? size.transposed() : size);
+        }
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Could not render edits of" << fileName << reader.errorString();
+        return QImage();
+    }
+
+    if (orientation != TOP_LEFT_ORIGIN)
+        image = image.transformed(OrientationCorrection::fromOrientation(orientation).toTransform());
+
+    image = image.convertToFormat(QImage::Format_RGB32);
+
+    if (state.isEnhanced) {
+        AutoEnhanceTransformation enhance(image);
+        transformPixels(&image, enhance);
+    }
+
+    if (state.hasColorBalance()) {
+        ColorBalance balance(state.brightness, state.contrast, state.saturation, state.hue);
+        transformPixels(&image, balance);
+    }
+
+    return image;
+}
+
+/*!
+ * \brief PhotoEditRenderer::preview returns a cached rendering of the edits of
+ * a photo, rendering it first if needed. Older previews of the photo are
+ * removed when a new one is rendered.
+ * \param mediaId
+ * \param fileName
+ * \param fileOrientation
+ * \param state
+ * \param maxSize
+ * \return the path of the preview, an empty string if it couldn't be rendered
+ */
+QString PhotoEditRenderer::preview(qint64 mediaId, const QString& fileName,
+                                   Orientation fileOrientation, const PhotoEditState& state,
+                                   const QSize& maxSize)
+{
+    if (m_previewDirectory.isEmpty())
+        return QString();
+
+    QFileInfo file(fileName);
+    QString key = QString("%1|%2|%3|%4x%5|%6").arg(file.absoluteFilePath())
+            .arg(file.lastModified().toMSecsSinceEpoch()).arg(fileOrientation)
+            .arg(maxSize.width()).arg(maxSize.height()).arg(state.cacheKey());
+    QByteArray hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Md5);
+
+    QDir directory(m_previewDirectory);
+    QString path = directory.filePath(QString("%1-%2.jpg").arg(mediaId)
+                                      .arg(QString(hash.toHex())));
+    if (QFile::exists(path))
+        return path;
+
+    QImage image = render(fileName, fileOrientation, state, maxSize);
+    if (image.isNull())
+        return QString();
+
+    removePreviews(mediaId);
+    if (!directory.mkpath(".")) {
+        qWarning() << "Unable to create preview directory" << m_previewDirectory;
+        return QString();
+    }
+
+    // Write under a temporary name, so a partial file is never picked up
+    QString tmpPath = path + ".tmp";
+    if (!image.save(tmpPath, "JPEG", PREVIEW_QUALITY) || !QFile::rename(tmpPath, path)) {
+        qWarning() << "Unable to write preview" << path;
+        QFile::remove(tmpPath);
+        return QString();
+    }
+
+    return path;
+}
+
+/*!
+ * \brief PhotoEditRenderer::removePreviews removes all the cached previews of
+ * a photo
+ * \param mediaId
+ */
+void PhotoEditRenderer::removePreviews(qint64 mediaId)
+{
+    if (m_previewDirectory.isEmpty())
+        return;
+
+    QDir directory(m_previewDirectory);
+    QStringList previews = directory.entryList(QStringList(QString("%1-*").arg(mediaId)),
+                                               QDir::Files);
+    foreach (const QString& preview, previews)
+        directory.remove(preview);
+}
+
+/*!
+ * \brief PhotoEditRenderer::setPreviewDirectory sets where the previews are
+ * cached. Nothing is cached until it is set.
+ * \param directory
+ */
+void PhotoEditRenderer::setPreviewDirectory(const QString& directory)
+{
+    m_previewDirectory = directory;
+}
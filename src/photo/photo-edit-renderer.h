@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GALLERY_PHOTO_EDIT_RENDERER_H_
+#define GALLERY_PHOTO_EDIT_RENDERER_H_
+
+// util
+#include "orientation.h"
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+class PhotoEditState;
+
+/*!
+ * \brief The PhotoEditRenderer class renders a PhotoEditState from the
+ * original file, and keeps a disk cache of the rendered previews.
+ *
+ * Only the cropped region of the file is decoded, directly at the size of the
+ * result when the image format supports it. A cached preview is reused as long
+ * as the file, the edits and the requested size stay the same, so showing an
+ * edited photo again costs a single decode of a small JPEG.
+ */
+class PhotoEditRenderer
+{
+public:
+    static QImage render(const QString& fileName, Orientation fileOrientation,
+                         const PhotoEditState& state, const QSize& maxSize);
+
+    static QString preview(qint64 mediaId, const QString& fileName,
+                           Orientation fileOrientation, const PhotoEditState& state,
+                           const QSize& maxSize);
+    static void removePreviews(qint64 mediaId);
+
+    static void setPreviewDirectory(const QString& directory);
+
+private:
+    static QString m_previewDirectory;
+};
+
+#endif  // GALLERY_PHOTO_EDIT_RENDERER_H_
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "photo-edit-state.h"
+
+#include <QStringList>
+
+/*!
+ * \brief PhotoEditState::PhotoEditState creates the state of an unedited photo
+ */
+PhotoEditState::PhotoEditState()
+    : cropRectangle(),
+      orientation(NO_ORIENTATION),
+      isEnhanced(false),
+      brightness(1.0),
+      contrast(1.0),
+      saturation(1.0),
+      hue(0.0)
+{
+}
+
+/*!
+ * \brief PhotoEditState::isOriginal
+ * \return true if rendering this state gives back the original photo
+ */
+bool PhotoEditState::isOriginal() const
+{
+    return cropRectangle.isNull() && orientation == NO_ORIENTATION &&
+            !isEnhanced && !hasColorBalance();
+}
+
+/*!
+ * \brief PhotoEditState::hasColorBalance
+ * \return true if any of the color balance values differs from the original
+ */
+bool PhotoEditState::hasColorBalance() const
+{
+    return !qFuzzyCompare(brightness, 1.0) || !qFuzzyCompare(contrast, 1.0) ||
+            !qFuzzyCompare(saturation, 1.0) || !qFuzzyIsNull(hue);
+}
+
+/*!
+ * \brief PhotoEditState::cropRectangleToString
+ * \return the crop rectangle as "x,y,width,height", an empty string if the
+ * photo isn't cropped
+ */
+QString PhotoEditState::cropRectangleToString() const
+{
+    if (cropRectangle.isNull())
+        return QString();
+
+    return QString("%1,%2,%3,%4").arg(cropRectangle.x()).arg(cropRectangle.y())
+            .arg(cropRectangle.width()).arg(cropRectangle.height());
+}
+
+/*!
+ * \brief PhotoEditState::setCropRectangleFromString parses a rectangle written
+ * by cropRectangleToString(). Anything else clears the crop rectangle.
+ * \param rect
+ */
+void PhotoEditState::setCropRectangleFromString(const QString& rect)
+{
+    cropRectangle = QRect();
+
+    QStringList parts = rect.split(',');
+    if (parts.size() != 4)
+        return;
+
+    bool ok[4];
+    QRect parsed(parts[0].toInt(&ok[0]), parts[1].toInt(&ok[1]),
+                 parts[2].toInt(&ok[2]), parts[3].toInt(&ok[3]));
+    if (ok[0] && ok[1] && ok[2] && ok[3] && parsed.isValid())
+        cropRectangle = parsed;
+}
+
+/*!
+ * \brief PhotoEditState::cacheKey
+ * \return a string that is the same for two states only if they render the
+ * same image
+ */
+QString PhotoEditState::cacheKey() const
+{
+    return QString("%1;%2;%3;%4;%5;%6;%7").arg(cropRectangleToString())
+            .arg(orientation).arg(isEnhanced)
+            .arg(brightness).arg(contrast).arg(saturation).arg(hue);
+}
+
+/*!
+ * \brief PhotoEditState::operator ==
+ * \param other
+ * \return
+ */
+bool PhotoEditState::operator==(const PhotoEditState& other) const
+{
+    return cropRectangle == other.cropRectangle &&
+            orientation == other.orientation &&
+            isEnhanced == other.isEnhanced &&
+            qFuzzyCompare(brightness, other.brightness) &&
+            qFuzzyCompare(contrast, other.contrast) &&
+            qFuzzyCompare(saturation, other.saturation) &&
+            qFuzzyCompare(1.0 + hue, 1.0 + other.hue);
+}
+
+/*!
+ * \brief PhotoEditState::operator !=
+ * \param other
+ * \return
+ */
+bool PhotoEditState::operator!=(const PhotoEditState& other) const
+{
+    return !(*this == other);
+}
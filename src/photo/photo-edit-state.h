@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GALLERY_PHOTO_EDIT_STATE_H_
+#define GALLERY_PHOTO_EDIT_STATE_H_
+
+// util
+#include "orientation.h"
+
+#include <QRect>
+#include <QString>
+
+// Orientation of an edit state that keeps the photo's own orientation
+const Orientation NO_ORIENTATION = static_cast<Orientation>(0);
+
+/*!
+ * \brief The PhotoEditState class holds the complete set of non-destructive
+ * edits applied to a photo: crop, rotation, auto-enhance and color balance.
+ *
+ * A state is rendered in that order. The crop rectangle is given in pixels of
+ * the original file, before any rotation.
+ */
+class PhotoEditState
+{
+public:
+    PhotoEditState();
+
+    bool isOriginal() const;
+    bool hasColorBalance() const;
+
+    QString cropRectangleToString() const;
+    void setCropRectangleFromString(const QString& rect);
+
+    QString cacheKey() const;
+
+    bool operator==(const PhotoEditState& other) const;
+    bool operator!=(const PhotoEditState& other) const;
+
+    QRect cropRectangle;
+    Orientation orientation;
+    bool isEnhanced;
+    qreal brightness;
+    qreal contrast;
+    qreal saturation;
+    qreal hue;
+};
+
+#endif  // GALLERY_PHOTO_EDIT_STATE_H_
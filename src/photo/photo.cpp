@@ -26,6 +26,7 @@
 // database
 #include "database.h"
 #include "media-table.h"
+#include "photo-edit-table.h"
 
 // media
 #include "media-collection.h"
@@ -33,6 +34,9 @@
 // medialoader
 #include "photo-metadata.h"
 
+// photo
+#include "photo-edit-renderer.h"
+
 // util
 #include "imaging.h"
 
@@ -79,7 +83,9 @@ bool Photo::isValid(const QFileInfo& file)
 Photo::Photo(const QFileInfo& file)
     : MediaSource(file),
       m_originalSize(),
-      m_originalOrientation(TOP_LEFT_ORIGIN)
+      m_originalOrientation(TOP_LEFT_ORIGIN),
+      m_photoEditTable(0),
+      m_editStateLoaded(false)
 {
     QByteArray format = QImageReader(file.filePath()).format();
     m_fileFormat = QString(format).toLower();
@@ -119,6 +125,8 @@ Orientation Photo::orientation() const
  */
 void Photo::destroySource(bool destroyBacking, bool asOrphan)
 {
+    PhotoEditRenderer::removePreviews(id());
+
     MediaSource::destroySource(destroyBacking, asOrphan);
 }
 
@@ -185,3 +193,174 @@ bool Photo::canBeEdited() const
 {
     return QImageWriter::supportedImageFormats().contains(m_fileFormat.toUtf8());
 }
+
+/*!
+ * \brief Photo::setPhotoEditTable sets the table storing the edits of the photo
+ * \param photoEditTable
+ */
+void Photo::setPhotoEditTable(PhotoEditTable *photoEditTable)
+{
+    m_photoEditTable = photoEditTable;
+    m_editStateLoaded = false;
+}
+
+/*!
+ * \brief Photo::editState
+ * \return the current non-destructive edits of the photo
+ */
+PhotoEditState Photo::editState() const
+{
+    if (!m_editStateLoaded && m_photoEditTable && id() != INVALID_ID) {
+        m_editState = m_photoEditTable->currentState(id());
+        m_editStateLoaded = true;
+    }
+
+    return m_editState;
+}
+
+/*!
+ * \brief Photo::isEdited
+ * \return true if the photo is shown with edits applied
+ */
+bool Photo::isEdited() const
+{
+    return !editState().isOriginal();
+}
+
+/*!
+ * \brief Photo::applyEdit puts state on top of the edit stack. The original
+ * file is left untouched.
+ * \param state the complete new edit state
+ */
+void Photo::applyEdit(const PhotoEditState& state)
+{
+    if (state == editState())
+        return;
+
+    if (m_photoEditTable)
+        m_photoEditTable->push(id(), state);
+    m_editState = state;
+
+    notifyEditStateChanged();
+}
+
+/*!
+ * \brief Photo::rotate rotates the photo by 90 degrees
+ * \param left
+ */
+void Photo::rotate(bool left)
+{
+    PhotoEditState state = editState();
+    Orientation current = state.orientation != NO_ORIENTATION ?
+                state.orientation : m_originalOrientation;
+    state.orientation = OrientationCorrection::rotateOrientation(current, left);
+    if (state.orientation == m_originalOrientation)
+        state.orientation = NO_ORIENTATION;
+
+    applyEdit(state);
+}
+
+/*!
+ * \brief Photo::crop crops the photo
+ * \param rect in pixels of the original file, before any rotation. An empty
+ * rectangle removes the crop.
+ */
+void Photo::crop(const QRect& rect)
+{
+    PhotoEditState state = editState();
+    state.cropRectangle = rect.isValid() ? rect : QRect();
+
+    applyEdit(state);
+}
+
+/*!
+ * \brief Photo::autoEnhance turns on the one-touch auto-enhance
+ */
+void Photo::autoEnhance()
+{
+    PhotoEditState state = editState();
+    state.isEnhanced = true;
+
+    applyEdit(state);
+}
+
+/*!
+ * \brief Photo::setColorBalance see ColorBalance for the meaning of the values
+ * \param brightness
+ * \param contrast
+ * \param saturation
+ * \param hue
+ */
+void Photo::setColorBalance(qreal brightness, qreal contrast,
+                            qreal saturation, qreal hue)
+{
+    PhotoEditState state = editState();
+    state.brightness = brightness;
+    state.contrast = contrast;
+    state.saturation = saturation;
+    state.hue = hue;
+
+    applyEdit(state);
+}
+
+/*!
+ * \brief Photo::undoEdit removes the last edit from the edit stack
+ * \return false if there was nothing to undo
+ */
+bool Photo::undoEdit()
+{
+    if (!m_photoEditTable || !m_photoEditTable->pop(id()))
+        return false;
+
+    m_editState = m_photoEditTable->currentState(id());
+    m_editStateLoaded = true;
+
+    notifyEditStateChanged();
+    return true;
+}
+
+/*!
+ * \brief Photo::revertToOriginal drops all the edits of the photo
+ */
+void Photo::revertToOriginal()
+{
+    if (!isEdited())
+        return;
+
+    if (m_photoEditTable)
+        m_photoEditTable->clear(id());
+    m_editState = PhotoEditState();
+
+    notifyEditStateChanged();
+}
+
+/*!
+ * \brief Photo::editPreview returns an image of the photo with its edits
+ * applied, fitting in width x height. It is rendered once and then read back
+ * from the preview cache.
+ * \param width
+ * \param height
+ * \return the URL of the preview, or the path of the photo if it isn't edited
+ */
+QUrl Photo::editPreview(int width, int height)
+{
+    if (!isEdited())
+        return path();
+
+    QString preview = PhotoEditRenderer::preview(id(), file().absoluteFilePath(),
+                                                 m_originalOrientation, editState(),
+                                                 QSize(width, height));
+    if (preview.isEmpty())
+        return path();
+
+    return QUrl::fromLocalFile(preview);
+}
+
+/*!
+ * \brief Photo::notifyEditStateChanged
+ */
+void Photo::notifyEditStateChanged()
+{
+    Q_EMIT editStateChanged();
+    notifyDataChanged();
+}
@@ -25,9 +25,14 @@
 // media
 #include "media-source.h"
 
+// photo
+#include "photo-edit-state.h"
+
 // util
 #include "orientation.h"
 
+class PhotoEditTable;
+
 /*!
  * \brief The Photo class
  */
@@ -36,6 +41,7 @@ class Photo : public MediaSource
     Q_OBJECT
 
     Q_PROPERTY(bool canBeEdited READ canBeEdited NOTIFY canBeEditedChanged)
+    Q_PROPERTY(bool isEdited READ isEdited NOTIFY editStateChanged)
 public:
     explicit Photo(const QFileInfo& file);
     virtual ~Photo();
@@ -56,20 +62,42 @@ public:
     bool fileFormatHasMetadata() const;
     bool fileFormatHasOrientation() const;
 
+    void setPhotoEditTable(PhotoEditTable *photoEditTable);
+    PhotoEditState editState() const;
+    bool isEdited() const;
+    void applyEdit(const PhotoEditState& state);
+
+    // Not exposed to QML until the viewer and thumbnails render the edits
+    void rotate(bool left);
+    void crop(const QRect& rect);
+    void autoEnhance();
+    void setColorBalance(qreal brightness, qreal contrast,
+                         qreal saturation, qreal hue);
+    bool undoEdit();
+    void revertToOriginal();
+    QUrl editPreview(int width, int height);
+
 signals:
     void canBeEditedChanged();
+    void editStateChanged();
  
 protected:
     virtual void destroySource(bool destroyBacking, bool asOrphan);
 
 private:
     void appendPathParams(QUrl* url, Orientation orientation, const int sizeLevel) const;
+    void notifyEditStateChanged();
 
     QString m_fileFormat;
 
     // We cache this data to avoid an image read at various times.
     QSize m_originalSize;
     Orientation m_originalOrientation;
+
+    // Top of the edit stack, read from the PhotoEditTable when first needed
+    PhotoEditTable *m_photoEditTable;
+    mutable PhotoEditState m_editState;
+    mutable bool m_editStateLoaded;
 };
 
 #endif  // GALLERY_PHOTO_H_
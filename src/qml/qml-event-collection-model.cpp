@@ -20,6 +20,7 @@
 #include "qml-event-collection-model.h"
 #include "event.h"
 #include "event-collection.h"
+#include "typed-collection.h"
 #include "variants.h"
 #include "gallery-manager.h"
 
@@ -71,10 +72,8 @@ bool QmlEventCollectionModel::isAccepted(DataObject* item)
     const ViewCollection* contents = event->contained();
     if (contents == 0) return false;
 
-    QList<DataObject*> items = contents->getAll();
-    foreach (DataObject* item, items) {
-        MediaSource *source = qobject_cast<MediaSource*>(item);
-        if (source != 0 && mediaTypeFilter() == source->type()) return true;
+    foreach (MediaSource* source, TypedCollection<MediaSource>(contents).all()) {
+        if (mediaTypeFilter() == source->type()) return true;
     }
     return false;
 }
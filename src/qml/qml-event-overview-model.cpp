@@ -25,6 +25,12 @@
 #include "variants.h"
 #include "gallery-manager.h"
 
+static const bool sortKeysRegistered =
+        DataCollection::registerSortKey(QmlEventOverviewModel::ascendingComparator,
+                                        QmlEventOverviewModel::ascendingKey)
+        && DataCollection::registerSortKey(QmlEventOverviewModel::descendingComparator,
+                                           QmlEventOverviewModel::descendingKey);
+
 /*!
  * \brief QmlEventOverviewModel::QmlEventOverviewModel
  * \param parent
@@ -104,7 +110,7 @@ void QmlEventOverviewModel::notifyBackingCollectionChanged()
 {
     monitorNewViewCollection();
 
-    QmlViewCollectionModel::notifyBackingCollectionChanged();
+    QmlMediaCollectionModel::notifyBackingCollectionChanged();
 }
 
 /*!
@@ -123,11 +129,13 @@ void QmlEventOverviewModel::monitorNewViewCollection()
 
     QObject::connect(
                 backingViewCollection(),
-                SIGNAL(selectionChanged(const QSet<DataObject*>*,const QSet<DataObject*>*)),
+                SIGNAL(selectionRangesChanged(const QList<IndexRange>*, bool)),
                 this,
-                SLOT(onEventOverviewSelectionChanged(const QSet<DataObject*>*,const QSet<DataObject*>*)));
+                SLOT(onEventOverviewSelectionRangesChanged(const QList<IndexRange>*, bool)));
 
     // seed existing contents with Events
+    m_mediaCount.clear();
+    m_selectedMediaCount.clear();
     onEventOverviewContentsChanged(&backingViewCollection()->getAsSet(), NULL, true);
 }
 
@@ -162,6 +170,17 @@ bool QmlEventOverviewModel::isAccepted(DataObject* item)
     return true;
 }
 
+/*!
+ * \brief QmlEventOverviewModel::isAcceptingAll
+ * The Events are added to the view next to the media, so it can't mirror the
+ * MediaCollection
+ * \return false
+ */
+bool QmlEventOverviewModel::isAcceptingAll() const
+{
+    return false;
+}
+
 /*!
  * \brief QmlEventOverviewModel::onEventOverviewContentsChanged
  * \param added
@@ -185,114 +204,96 @@ void QmlEventOverviewModel::onEventOverviewContentsChanged(
 
             if (!view->contains(event))
                 view->add(event);
+
+            ++m_mediaCount[source_date];
         }
     }
-}
 
-/*!
- * \brief QmlEventOverviewModel::onEventOverviewSelectionChanged
- * \param selected
- * \param unselected
- */
-void QmlEventOverviewModel::onEventOverviewSelectionChanged(
-        const QSet<DataObject*>* selected, const QSet<DataObject*>* unselected)
-{
-    // if an Event is selected, select all photos in that date
-    syncSelectedMedia(selected, true);
+    if (removed != NULL) {
+        DataObject* object;
+        foreach (object, *removed) {
+            MediaSource* source = qobject_cast<MediaSource*>(object);
+            if (source == NULL)
+                continue;
 
-    // if an Event is unselected, unselect all photos in that date
-    syncSelectedMedia(unselected, false);
+            QDate source_date = source->exposureDateTime().date();
+            if (--m_mediaCount[source_date] <= 0)
+                m_mediaCount.remove(source_date);
+        }
+    }
 }
 
 /*!
- * \brief QmlEventOverviewModel::syncSelectedMedia
- * \param toggled
+ * \brief QmlEventOverviewModel::onEventOverviewSelectionRangesChanged keeps the
+ * selection of the Events and their media in step: an Event (un)selects all its
+ * media, and is selected only while all its media are
+ * \param ranges
  * \param selected
  */
-void QmlEventOverviewModel::syncSelectedMedia(const QSet<DataObject*>* toggled,
-                                              bool selected)
+void QmlEventOverviewModel::onEventOverviewSelectionRangesChanged(
+        const QList<IndexRange>* ranges, bool selected)
 {
-    if (toggled == NULL)
-        return;
+    SelectableViewCollection* view = backingViewCollection();
+
+    QList<Event*> toggled;
+    QSet<QDate> touched;
+    IndexRange range;
+    foreach (range, *ranges) {
+        for (int index = range.first; index <= range.last; ++index) {
+            DataObject* object = view->getAt(index);
+            MediaSource* media = qobject_cast<MediaSource*>(object);
+            if (media == NULL) {
+                Event* event = qobject_cast<Event*>(object);
+                if (event != NULL)
+                    toggled.append(event);
+
+                continue;
+            }
+
+            QDate date = media->exposureDateTime().date();
+            int& count = m_selectedMediaCount[date];
+            count += selected ? 1 : -1;
+            if (count <= 0)
+                m_selectedMediaCount.remove(date);
+            touched.insert(date);
+        }
+    }
 
     // Don't recurse -- only take action from the selection made by the user, not
-    // any other selections we've done internally.
+    // any other selections we've done internally. The counts are kept either way.
     if (m_syncingMedia)
         return;
 
     m_syncingMedia = true;
 
-    SelectableViewCollection* view = backingViewCollection();
-    int count = view->count();
-
-    // Walk the toggle group looking for Event's; when found, walk all the
-    // MediaSources that follow and select or unselect them; when another
-    // Event is found (or end of list), exit
-    //
-    // TODO: Select/Unselect in bulk operations for efficiency
-    DataObject* object;
-    foreach (object, *toggled) {
-        Event* event = qobject_cast<Event*>(object);
-        if (event == NULL)
-            continue;
-
-        int index = view->indexOf(event);
-        for (int ctr = index + 1; ctr < count; ctr++) {
-            MediaSource* media = qobject_cast<MediaSource*>(view->getAt(ctr));
-            if (media == NULL)
-                break;
-
+    // if an Event is selected or unselected, so is the span of media following
+    // it, at once
+    Event* event;
+    foreach (event, toggled) {
+        int first = view->indexOf(event) + 1;
+        int last = first + m_mediaCount.value(event->date()) - 1;
+        if (first <= last) {
             if (selected)
-                view->select(media);
+                view->selectRange(first, last);
             else
-                view->unselect(media);
-        }
-    }
-
-    // The other case is when the user is selecting or deselecting media.  We
-    // walk around looking for other media to see if we should select or deselect
-    // the containing event.
-    //
-    // TODO: Select/Unselect in bulk operations for efficiency
-    foreach (object, *toggled) {
-        MediaSource* media = qobject_cast<MediaSource*>(object);
-        if (media == NULL)
-            break;
-
-        int index = view->indexOf(media);
-        bool all_match_selection = true;
-
-        // First walk forward to the next event/end of list looking for differing
-        // selection states in other media.
-        for (int i = index + 1; i < count; ++i) {
-            MediaSource* media = qobject_cast<MediaSource*>(view->getAt(i));
-            if (media == NULL)
-                break;
-
-            if (view->isSelected(media) != selected) {
-                all_match_selection = false;
-                break;
-            }
+                view->unselectRange(first, last);
         }
 
-        // Now walk backwards also checking media, and looking for the event.
-        for (int i = index - 1; i >= 0; --i) {
-            MediaSource* media = qobject_cast<MediaSource*>(view->getAt(i));
-            Event* event = qobject_cast<Event*>(view->getAt(i));
+        touched.remove(event->date());
+    }
 
-            if (media != NULL) {
-                if (view->isSelected(media) != selected)
-                    all_match_selection = false;
-            }
+    // The other case is when the user is selecting or deselecting media: the
+    // Event containing them is selected when all of its media are
+    QDate date;
+    foreach (date, touched) {
+        event = GalleryManager::instance()->eventCollection()->eventForDate(date);
+        if (event == NULL || !view->contains(event))
+            continue;
 
-            if (event != NULL) {
-                if (all_match_selection && selected)
-                    view->select(event);
-                else
-                    view->unselect(event);
-                break;
-            }
-        }
+        if (m_selectedMediaCount.value(date) == m_mediaCount.value(date))
+            view->select(event);
+        else
+            view->unselect(event);
     }
 
     m_syncingMedia = false;
@@ -306,7 +307,7 @@ void QmlEventOverviewModel::syncSelectedMedia(const QSet<DataObject*>* toggled,
  */
 bool QmlEventOverviewModel::ascendingComparator(DataObject* a, DataObject* b)
 {
-    return eventComparator(a, b, true);
+    return ascendingKey(a) < ascendingKey(b);
 }
 
 /*!
@@ -317,30 +318,28 @@ bool QmlEventOverviewModel::ascendingComparator(DataObject* a, DataObject* b)
  */
 bool QmlEventOverviewModel::descendingComparator(DataObject* a, DataObject* b)
 {
-    return eventComparator(a, b, false);
+    return descendingKey(a) < descendingKey(b);
 }
 
 /*!
- * \brief QmlEventOverviewModel::eventComparator
- * \param a
- * \param b
- * \param asc
+ * \brief QmlEventOverviewModel::ascendingKey
+ * Ties are broken by DataObjectNumber, in the same direction as the dates.
+ * \param object
+ * \return
+ */
+DataObjectKey QmlEventOverviewModel::ascendingKey(DataObject* object)
+{
+    return DataObjectKey(objectDateTime(object, true).toMSecsSinceEpoch(), object->number());
+}
+
+/*!
+ * \brief QmlEventOverviewModel::descendingKey
+ * \param object
  * \return
  */
-bool QmlEventOverviewModel::eventComparator(DataObject* a, DataObject* b, bool asc)
+DataObjectKey QmlEventOverviewModel::descendingKey(DataObject* object)
 {
-    QDateTime atime = objectDateTime(a, asc);
-    QDateTime btime = objectDateTime(b, asc);
-
-    // use default comparator to stabilize order (reversing comparison for descending
-    // order)
-    bool lessThan;
-    if (atime != btime)
-        lessThan = atime < btime;
-    else
-        lessThan = DataCollection::defaultDataObjectComparator(a, b);
-
-    return (asc) ? lessThan : !lessThan;
+    return DataObjectKey(-objectDateTime(object, false).toMSecsSinceEpoch(), -object->number());
 }
 
 /*!
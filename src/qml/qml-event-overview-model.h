@@ -22,6 +22,7 @@
 
 #include <QObject>
 #include <QDateTime>
+#include <QHash>
 #include <QSet>
 #include <QVariant>
 #include <QtQml>
@@ -48,6 +49,12 @@ public:
     bool ascendingOrder() const;
     void setAscendingOrder(bool ascending);
     bool isAccepted(DataObject* item);
+    bool isAcceptingAll() const;
+
+    static bool ascendingComparator(DataObject* a, DataObject* b);
+    static bool descendingComparator(DataObject* a, DataObject* b);
+    static DataObjectKey ascendingKey(DataObject* object);
+    static DataObjectKey descendingKey(DataObject* object);
 
 protected:
     virtual void notifyBackingCollectionChanged();
@@ -62,20 +69,20 @@ private slots:
     void onEventOverviewContentsChanged(const QSet<DataObject*>* added,
                                         const QSet<DataObject*>* removed,
                                         bool notify);
-    void onEventOverviewSelectionChanged(const QSet<DataObject*>* selected,
-                                         const QSet<DataObject*>* unselected);
+    void onEventOverviewSelectionRangesChanged(const QList<IndexRange>* ranges,
+                                               bool selected);
 
 private:
-    static bool ascendingComparator(DataObject* a, DataObject* b);
-    static bool descendingComparator(DataObject* a, DataObject* b);
-    static bool eventComparator(DataObject* a, DataObject* b, bool desc);
     static QDateTime objectDateTime(DataObject* object, bool desc);
 
     void monitorNewViewCollection();
-    void syncSelectedMedia(const QSet<DataObject*>* toggled, bool selected);
 
     bool m_ascendingOrder;
     bool m_syncingMedia;
+    // Number of media in the view, and of those selected, per Event date; the
+    // media of an Event follow it in the view
+    QHash<QDate, int> m_mediaCount;
+    QHash<QDate, int> m_selectedMediaCount;
 };
 
 QML_DECLARE_TYPE(QmlEventOverviewModel)
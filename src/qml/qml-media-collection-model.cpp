@@ -36,6 +36,7 @@
 // media
 #include "media-source.h"
 #include "media-collection.h"
+#include "media-prefetcher.h"
 
 // util
 #include "variants.h"
@@ -50,6 +51,7 @@
 QmlMediaCollectionModel::QmlMediaCollectionModel(QObject* parent)
     : QmlViewCollectionModel(parent, "mediaSource", NULL)
 {
+    addMediaRoles();
 }
 
 /*!
@@ -61,6 +63,16 @@ QmlMediaCollectionModel::QmlMediaCollectionModel(QObject* parent,
                                                  DataObjectComparator default_comparator)
     : QmlViewCollectionModel(parent, "mediaSource", default_comparator)
 {
+    addMediaRoles();
+}
+
+/*!
+ * \brief QmlMediaCollectionModel::addMediaRoles
+ */
+void QmlMediaCollectionModel::addMediaRoles()
+{
+    addRole(ThumbnailRole, "thumbnailUrl");
+    addRole(MediaTypeRole, "mediaType");
 }
 
 /*!
@@ -159,6 +171,23 @@ void QmlMediaCollectionModel::setMonitored(bool monitor)
     monitoringChanged();
 }
 
+/*!
+ * \brief QmlMediaCollectionModel::notifyBackingCollectionChanged
+ */
+void QmlMediaCollectionModel::notifyBackingCollectionChanged()
+{
+    // The media roles aren't bound to the MediaSources, so their changes are
+    // followed here
+    MediaCollection* media = GalleryManager::instance()->mediaCollection();
+    if (media != NULL) {
+        QObject::connect(media, SIGNAL(contentDataChanged(DataObject*)),
+                         this, SLOT(onMediaDataChanged(DataObject*)),
+                         Qt::UniqueConnection);
+    }
+
+    QmlViewCollectionModel::notifyBackingCollectionChanged();
+}
+
 /*!
  * \brief QmlMediaCollectionModel::toVariant
  * \param object
@@ -192,3 +221,59 @@ bool QmlMediaCollectionModel::isAccepted(DataObject *item)
     MediaSource* source = qobject_cast<MediaSource*>(item);
     return source != 0 && source->type() == mediaTypeFilter();
 }
+
+/*!
+ * \brief QmlMediaCollectionModel::dataForRole
+ * \param object
+ * \param role
+ * \return
+ */
+QVariant QmlMediaCollectionModel::dataForRole(DataObject* object, int role) const
+{
+    MediaSource* media = qobject_cast<MediaSource*>(object);
+    if (media == NULL)
+        return QVariant();
+
+    switch (role) {
+    case ThumbnailRole:
+        return QVariant(QString("image://thumbnailer/") + media->path().toString()
+                        + "?at=" + QString::number(media->lastModified()));
+
+    case MediaTypeRole:
+        return QVariant((int) media->type());
+
+    default:
+        return QVariant();
+    }
+}
+
+/*!
+ * \brief QmlMediaCollectionModel::prefetch
+ * \param objects
+ */
+void QmlMediaCollectionModel::prefetch(const QList<DataObject*>& objects)
+{
+    MediaPrefetcher* prefetcher = GalleryManager::instance()->prefetcher();
+    if (prefetcher != NULL)
+        prefetcher->setQueue(this, CastListToType<DataObject*, MediaSource*>(
+                                 FilterListOnlyType<DataObject*, MediaSource*>(objects)));
+}
+
+/*!
+ * \brief QmlMediaCollectionModel::onMediaDataChanged updates the media roles
+ * of the row showing the object, if any
+ * \param object
+ */
+void QmlMediaCollectionModel::onMediaDataChanged(DataObject* object)
+{
+    SelectableViewCollection* view = backingViewCollection();
+    if (view == NULL)
+        return;
+
+    int index = view->indexOf(object);
+    if (index < 0)
+        return;
+
+    for (int role = ThumbnailRole; role < LastMediaRole; ++role)
+        notifyElementChanged(index, role);
+}
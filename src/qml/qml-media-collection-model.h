@@ -42,6 +42,13 @@ signals:
     void monitoringChanged();
 
 public:
+    // Values of the MediaSource the delegates bind to directly
+    enum MediaRole {
+        ThumbnailRole = LastCommonRole,
+        MediaTypeRole,
+        LastMediaRole
+    };
+
     QmlMediaCollectionModel(QObject* parent = NULL);
     QmlMediaCollectionModel(QObject* parent, DataObjectComparator defaultComparator);
 
@@ -55,8 +62,18 @@ public:
     bool isAccepted(DataObject *item);
 
 protected:
+    virtual void notifyBackingCollectionChanged();
+
     virtual QVariant toVariant(DataObject* object) const;
     virtual DataObject* fromVariant(QVariant var) const;
+    virtual QVariant dataForRole(DataObject* object, int role) const;
+    virtual void prefetch(const QList<DataObject*>& objects);
+
+private slots:
+    void onMediaDataChanged(DataObject* object);
+
+private:
+    void addMediaRoles();
 };
 
 QML_DECLARE_TYPE(QmlMediaCollectionModel)
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "qml-search-model.h"
+
+// database
+#include "database.h"
+#include "search-table.h"
+
+// core
+#include "selectable-view-collection.h"
+
+// media
+#include "media-collection.h"
+#include "media-source.h"
+
+// src
+#include "gallery-manager.h"
+
+/*!
+ * \brief QmlSearchModel::QmlSearchModel
+ * \param parent
+ */
+QmlSearchModel::QmlSearchModel(QObject* parent)
+    : QmlMediaCollectionModel(parent),
+      m_refreshPending(false)
+{
+    QObject::connect(GalleryManager::instance()->database()->getSearchTable(),
+                     SIGNAL(indexChanged()), this, SLOT(onIndexChanged()));
+}
+
+/*!
+ * \brief QmlSearchModel::query
+ * \return
+ */
+QString QmlSearchModel::query() const
+{
+    return m_query;
+}
+
+/*!
+ * \brief QmlSearchModel::setQuery looks the query up in the search index and
+ * updates the model with the media matching now and no longer
+ * \param query
+ */
+void QmlSearchModel::setQuery(const QString& query)
+{
+    if (m_query == query)
+        return;
+
+    m_query = query;
+    refreshMatches();
+
+    Q_EMIT queryChanged();
+}
+
+/*!
+ * \brief QmlSearchModel::isAccepted
+ * \param item
+ * \return true if the item matched the query and the mediaTypeFilter
+ */
+bool QmlSearchModel::isAccepted(DataObject* item)
+{
+    MediaSource* source = qobject_cast<MediaSource*>(item);
+    if (source == 0)
+        return false;
+
+    if (!m_matches.contains(source->id()))
+        return false;
+
+    return QmlMediaCollectionModel::isAccepted(item);
+}
+
+/*!
+ * \brief QmlSearchModel::isAcceptingAll
+ * \return false, only the matches are accepted
+ */
+bool QmlSearchModel::isAcceptingAll() const
+{
+    return false;
+}
+
+/*!
+ * \brief QmlSearchModel::updateMatches brings the view from the previous
+ * matches to the current ones, through the changed ones only
+ * \param previous
+ */
+void QmlSearchModel::updateMatches(const QSet<qint64>& previous)
+{
+    MediaCollection* mediaCollection = GalleryManager::instance()->mediaCollection();
+    SelectableViewCollection* view = backingViewCollection();
+
+    QSet<DataObject*> to_remove;
+    QSet<DataObject*> to_add;
+    qint64 id;
+    foreach (id, previous) {
+        if (m_matches.contains(id))
+            continue;
+
+        MediaSource* source = mediaCollection->mediaForId(id);
+        if (source != NULL && view->contains(source))
+            to_remove.insert(source);
+    }
+
+    foreach (id, m_matches) {
+        if (previous.contains(id))
+            continue;
+
+        MediaSource* source = mediaCollection->mediaForId(id);
+        if (source != NULL && isAccepted(source))
+            to_add.insert(source);
+    }
+
+    view->beginBatch();
+    view->removeMany(to_remove, true);
+    view->addMany(to_add);
+    view->endBatch();
+}
+
+/*!
+ * \brief QmlSearchModel::onIndexChanged schedules a new search, as media or
+ * albums were indexed, renamed or removed, or album contents changed
+ */
+void QmlSearchModel::onIndexChanged()
+{
+    if (m_refreshPending || m_query.isEmpty())
+        return;
+
+    m_refreshPending = true;
+    QMetaObject::invokeMethod(this, "refreshMatches", Qt::QueuedConnection);
+}
+
+/*!
+ * \brief QmlSearchModel::refreshMatches searches the query again and updates
+ * the model with the difference
+ */
+void QmlSearchModel::refreshMatches()
+{
+    m_refreshPending = false;
+
+    QSet<qint64> previous = m_matches;
+    m_matches.clear();
+    GalleryManager::instance()->database()->getSearchTable()->search(m_query, &m_matches);
+
+    if (isMonitoring())
+        updateMatches(previous);
+    else if (!m_matches.isEmpty())
+        monitorSourceCollection(GalleryManager::instance()->mediaCollection());
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GALLERY_QML_SEARCH_MODEL_H_
+#define GALLERY_QML_SEARCH_MODEL_H_
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QtQml>
+
+#include "qml-media-collection-model.h"
+
+class DataObject;
+
+/*!
+ * \brief The QmlSearchModel class lists the media matching a search query.
+ * The query is looked up in the full-text search index, see SearchTable.
+ */
+class QmlSearchModel : public QmlMediaCollectionModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+
+signals:
+    void queryChanged();
+
+public:
+    QmlSearchModel(QObject* parent = NULL);
+
+    QString query() const;
+    void setQuery(const QString& query);
+
+    bool isAccepted(DataObject* item);
+    bool isAcceptingAll() const;
+
+private slots:
+    void onIndexChanged();
+    void refreshMatches();
+
+private:
+    void updateMatches(const QSet<qint64>& previous);
+
+    QString m_query;
+    QSet<qint64> m_matches;
+    // Set while a refreshMatches() is queued, so that the index changes of an
+    // event loop turn lead to a single search
+    bool m_refreshPending;
+};
+
+QML_DECLARE_TYPE(QmlSearchModel)
+
+#endif  // GALLERY_QML_SEARCH_MODEL_H_
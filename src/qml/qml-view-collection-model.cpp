@@ -27,6 +27,16 @@
 // util
 #include "variants.h"
 
+#include <QMap>
+
+#include <algorithm>
+
+// How many times the visible rows are prefetched ahead of them
+static const int PREFETCH_PAGES_AHEAD = 2;
+// Bounds on the rows prefetched, whatever range the view reports
+static const int PREFETCH_MAX_VISIBLE_ROWS = 100;
+static const int PREFETCH_MAX_ROWS_AHEAD = 200;
+
 /*!
  * \brief QmlViewCollectionModel::QmlViewCollectionModel
  * \param parent
@@ -36,7 +46,8 @@
 QmlViewCollectionModel::QmlViewCollectionModel(QObject* parent, const QString& objectTypeName,
                                                DataObjectComparator defaultComparator)
     : QAbstractListModel(parent), m_view(NULL), m_defaultComparator(defaultComparator),
-      m_head(0), m_limit(-1), m_mediaTypeFilter(MediaSource::None)
+      m_head(0), m_limit(-1), m_mediaTypeFilter(MediaSource::None),
+      m_flushScheduled(false)
 {
     m_roles.insert(ObjectRole, "object");
     m_roles.insert(SelectionRole, "isSelected");
@@ -215,6 +226,28 @@ void QmlViewCollectionModel::unselectAll()
         m_view->unselectAll();
 }
 
+/*!
+ * \brief QmlViewCollectionModel::selectRange
+ * \param first
+ * \param last
+ */
+void QmlViewCollectionModel::selectRange(int first, int last)
+{
+    if (m_view != NULL)
+        m_view->selectRange(first, last);
+}
+
+/*!
+ * \brief QmlViewCollectionModel::unselectRange
+ * \param first
+ * \param last
+ */
+void QmlViewCollectionModel::unselectRange(int first, int last)
+{
+    if (m_view != NULL)
+        m_view->unselectRange(first, last);
+}
+
 /*!
  * \brief QmlViewCollectionModel::toggleSelection
  * \param var
@@ -237,6 +270,60 @@ bool QmlViewCollectionModel::isSelected(const QVariant &var) const
             : false);
 }
 
+/*!
+ * \brief QmlViewCollectionModel::setVisibleRange tells which rows the view
+ * shows, so the objects about to be shown can be prefetched: the visible ones
+ * first, then those ahead in the direction scrolled to. The rows that scrolled
+ * away are no longer prefetched.
+ * \param first
+ * \param last
+ * \param direction negative when scrolling towards the first rows, positive
+ * towards the last ones, 0 if not scrolling
+ */
+void QmlViewCollectionModel::setVisibleRange(int first, int last, int direction)
+{
+    if (m_view == NULL)
+        return;
+
+    int rows = count();
+    first = qMax(first, 0);
+    last = qMin(last, rows - 1);
+    if (first > last)
+        return;
+
+    // Keep the end of the range the view scrolls from
+    if (last - first + 1 > PREFETCH_MAX_VISIBLE_ROWS) {
+        if (direction < 0)
+            first = last - PREFETCH_MAX_VISIBLE_ROWS + 1;
+        else
+            last = first + PREFETCH_MAX_VISIBLE_ROWS - 1;
+    }
+
+    int ahead = qMin((last - first + 1) * PREFETCH_PAGES_AHEAD, PREFETCH_MAX_ROWS_AHEAD);
+    QList<int> order;
+    if (direction < 0) {
+        for (int row = last; row >= qMax(first - ahead, 0); --row)
+            order.append(row);
+    } else {
+        for (int row = first; row <= qMin(last + ahead, rows - 1); ++row)
+            order.append(row);
+
+        // not scrolling, so it could go either way
+        if (direction == 0) {
+            for (int row = first - 1; row >= qMax(first - ahead, 0); --row)
+                order.append(row);
+        }
+    }
+
+    int start = windowStart(m_view->count());
+    QList<DataObject*> objects;
+    int row;
+    foreach (row, order)
+        objects.append(m_view->getAt(start + row));
+
+    prefetch(objects);
+}
+
 /*!
  * \brief QmlViewCollectionModel::rowCount
  * \param parent
@@ -258,22 +345,11 @@ QVariant QmlViewCollectionModel::data(const QModelIndex& index, int role) const
     if (m_view == NULL)
         return QVariant();
 
-    if (m_limit == 0)
-        return QVariant();
-
-    // calculate actual starting index from the head (a negative head means to
-    // start from n elements from the tail of the list; relying on negative value
-    // for addition in latter part of ternary operator her)
-    int real_start = (m_head >= 0) ? m_head : m_view->count() + m_head;
-    int real_index = index.row() + real_start;
-
     // bounds checking
-    if (real_index < 0 || real_index >= m_view->count())
+    if (index.row() < 0 || index.row() >= count())
         return QVariant();
 
-    // watch for indexing beyond upper limit
-    if (m_limit > 0 && real_index >= (real_start + m_limit))
-        return QVariant();
+    int real_index = index.row() + windowStart(m_view->count());
 
     DataObject* object = m_view->getAt(real_index);
     if (object == NULL)
@@ -285,14 +361,23 @@ QVariant QmlViewCollectionModel::data(const QModelIndex& index, int role) const
         return toVariant(object);
 
     case SelectionRole:
-        return QVariant(m_view->isSelected(object));
+        return QVariant(m_view->isSelectedAt(real_index));
+
+    case TypeNameRole: {
+        QVariant var = toVariant(object);
+        QHash<int, QVariant>::const_iterator typeName = m_typeNames.constFind(var.userType());
+        if (typeName != m_typeNames.constEnd())
+            return typeName.value();
 
-    case TypeNameRole:
         // Return type name with the pointer ("*") removed
-        return QVariant(QString(toVariant(object).typeName()).remove('*'));
+        QVariant name(QString(var.typeName()).remove('*'));
+        m_typeNames.insert(var.userType(), name);
+
+        return name;
+    }
 
     default:
-        return QVariant();
+        return dataForRole(object, role);
     }
 }
 
@@ -302,20 +387,7 @@ QVariant QmlViewCollectionModel::data(const QModelIndex& index, int role) const
  */
 int QmlViewCollectionModel::count() const
 {
-    int count = (m_view != NULL) ? m_view->count() : 0;
-
-    // account for head (if negative, means head of list starts at tail)
-    count -= (m_head > 0) ? m_head : (-m_head);
-
-    // watch for underflow
-    if (count < 0)
-        count = 0;
-
-    // apply limit, if set
-    if (m_limit >= 0 && count > m_limit)
-        count = m_limit;
-
-    return count;
+    return windowCount(rawCount());
 }
 
 /*!
@@ -354,12 +426,13 @@ void QmlViewCollectionModel::setHead(int head) {
     if (m_head == head)
         return;
 
+    QVector<int> positions = windowPositions();
+
     m_head = head;
 
     emit headChanged();
-    // TODO: this could be checked for and optimized instead of nuking it all.
+    notifyWindowChanged(positions);
     emit countChanged();
-    notifyReset();
 }
 
 /*!
@@ -382,11 +455,13 @@ void QmlViewCollectionModel::setLimit(int limit)
     if (m_limit == normalized)
         return;
 
+    QVector<int> positions = windowPositions();
+
     m_limit = normalized;
 
     emit limitChanged();
+    notifyWindowChanged(positions);
     emit countChanged();
-    notifyReset();
 }
 
 /*!
@@ -404,7 +479,10 @@ void QmlViewCollectionModel::clearLimit()
 QList<MediaSource*> QmlViewCollectionModel::selectedMedias() const
 {
     QList<MediaSource*> selectedList;
-    QSet<DataObject*> totalSelection = m_view->getSelected();
+    if (m_view == NULL)
+        return selectedList;
+
+    QList<DataObject*> totalSelection = m_view->getSelectedPage(0, -1);
     foreach (DataObject* data, totalSelection) {
         MediaSource *media = qobject_cast<MediaSource*>(data);
         if (media)
@@ -414,10 +492,24 @@ QList<MediaSource*> QmlViewCollectionModel::selectedMedias() const
 }
 
 QVariantList QmlViewCollectionModel::selectedMediasQML() const
+{
+    return selectedPage(0, -1);
+}
+
+/*!
+ * \brief QmlViewCollectionModel::selectedPage
+ * \param offset number of selected items to skip
+ * \param limit most items to return, or -1 for all of them
+ * \return the selected items, in the order of the model
+ */
+QVariantList QmlViewCollectionModel::selectedPage(int offset, int limit) const
 {
     QVariantList selectedList;
-    QSet<DataObject*> totalSelection = m_view->getSelected();
-    foreach (DataObject* data, totalSelection) {
+    if (m_view == NULL)
+        return selectedList;
+
+    QList<DataObject*> page = m_view->getSelectedPage(offset, limit);
+    foreach (DataObject* data, page) {
         QVariant var;
         var.setValue(data);
         selectedList << var;
@@ -443,19 +535,22 @@ void QmlViewCollectionModel::setBackingViewCollection(SelectableViewCollection*
     endResetModel();
 
     QObject::connect(m_view,
-                     SIGNAL(selectionChanged(const QSet<DataObject*>*, const QSet<DataObject*>*)),
+                     SIGNAL(selectionRangesChanged(const QList<IndexRange>*, bool)),
                      this,
-                     SLOT(onSelectionChanged(const QSet<DataObject*>*, const QSet<DataObject*>*)));
+                     SLOT(onSelectionRangesChanged(const QList<IndexRange>*, bool)));
 
     QObject::connect(m_view,
-                     SIGNAL(contentsAboutToBeChanged(const QSet<DataObject*>*, const QSet<DataObject*>*)),
+                     SIGNAL(rangesInserted(const QList<IndexRange>*)),
                      this,
-                     SLOT(onContentsAboutToBeChanged(const QSet<DataObject*>*, const QSet<DataObject*>*)));
+                     SLOT(onRangesInserted(const QList<IndexRange>*)));
 
     QObject::connect(m_view,
-                     SIGNAL(contentsChanged(const QSet<DataObject*>*, const QSet<DataObject*>*, bool)),
+                     SIGNAL(rangesRemoved(const QList<IndexRange>*, bool)),
                      this,
-                     SLOT(onContentsChanged(const QSet<DataObject*>*, const QSet<DataObject*>*, bool)));
+                     SLOT(onRangesRemoved(const QList<IndexRange>*, bool)));
+
+    QObject::connect(m_view, SIGNAL(orderingAboutToBeChanged()),
+                     this, SLOT(onOrderingAboutToBeChanged()));
 
     QObject::connect(m_view, SIGNAL(orderingChanged()),
                      this, SLOT(onOrderingChanged()));
@@ -482,23 +577,29 @@ void QmlViewCollectionModel::disconnectBackingViewCollection()
         return;
 
     QObject::disconnect(m_view,
-                        SIGNAL(selectionChanged(const QSet<DataObject*>*, const QSet<DataObject*>*)),
+                        SIGNAL(selectionRangesChanged(const QList<IndexRange>*, bool)),
                         this,
-                        SLOT(onSelectionChanged(const QSet<DataObject*>*, const QSet<DataObject*>*)));
+                        SLOT(onSelectionRangesChanged(const QList<IndexRange>*, bool)));
 
     QObject::disconnect(m_view,
-                        SIGNAL(contentsAboutToBeChanged(const QSet<DataObject*>*, const QSet<DataObject*>*)),
+                        SIGNAL(rangesInserted(const QList<IndexRange>*)),
                         this,
-                        SLOT(onContentsAboutToBeChanged(const QSet<DataObject*>*, const QSet<DataObject*>*)));
+                        SLOT(onRangesInserted(const QList<IndexRange>*)));
 
     QObject::disconnect(m_view,
-                        SIGNAL(contentsChanged(const QSet<DataObject*>*, const QSet<DataObject*>*, bool)),
+                        SIGNAL(rangesRemoved(const QList<IndexRange>*, bool)),
                         this,
-                        SLOT(onContentsChanged(const QSet<DataObject*>*, const QSet<DataObject*>*, bool)));
+                        SLOT(onRangesRemoved(const QList<IndexRange>*, bool)));
+
+    QObject::disconnect(m_view, SIGNAL(orderingAboutToBeChanged()),
+                        this, SLOT(onOrderingAboutToBeChanged()));
 
     QObject::disconnect(m_view, SIGNAL(orderingChanged()),
                         this, SLOT(onOrderingChanged()));
 
+    // the reset below covers them
+    m_changedRoles.clear();
+
     beginResetModel();
 
     delete m_view;
@@ -544,6 +645,17 @@ bool QmlViewCollectionModel::isAccepted(DataObject* item)
     return true;
 }
 
+/*!
+ * \brief QmlViewCollectionModel::isAcceptingAll
+ * Subclasses with a filter of their own besides the mediaTypeFilter must
+ * override this.
+ * \return true if no mediaTypeFilter is set
+ */
+bool QmlViewCollectionModel::isAcceptingAll() const
+{
+    return m_mediaTypeFilter == MediaSource::None;
+}
+
 /*!
  * \brief QmlViewCollectionModel::monitorSourceCollection
  * \param sources
@@ -581,22 +693,18 @@ MediaSource::MediaType QmlViewCollectionModel::mediaTypeFilter() const
     return m_mediaTypeFilter;
 }
 
+/*!
+ * \brief QmlViewCollectionModel::setMediaTypeFilter filters the backing view
+ * again, so only the rows whose acceptance changed are removed or inserted and
+ * the selection of the others is kept
+ * \param mediaTypeFilter
+ */
 void QmlViewCollectionModel::setMediaTypeFilter(MediaSource::MediaType mediaTypeFilter)
 {
     if (m_mediaTypeFilter != mediaTypeFilter) {
-        const DataCollection* collection = 0;
-        QString viewName;
-
-        if (m_view) {
-            collection = m_view->collection();
-            viewName = m_view->toString();
-            disconnectBackingViewCollection();
-        }
-
         m_mediaTypeFilter = mediaTypeFilter;
-        if (collection) {
-            monitorCollection(collection, viewName);
-        }
+        if (m_view != NULL)
+            m_view->refilter();
 
         Q_EMIT mediaTypeFilterChanged();
     }
@@ -660,16 +768,17 @@ void QmlViewCollectionModel::notifyElementsAdded(int first, int last)
 }
 
 /*!
- * \brief QmlViewCollectionModel::notifyElementRemoved
- * This notifies model subscribers that the element at this index was
- * removed ... note that QmlViewCollectionModel monitors the
+ * \brief QmlViewCollectionModel::notifyElementsRemoved
+ * This notifies model subscribers that the elements between these indexes
+ * were removed ... note that QmlViewCollectionModel monitors the
  * SelectableViewCollections' "contents-altered" signal already
- * \param index
+ * \param first
+ * \param last
  */
-void QmlViewCollectionModel::notifyElementRemoved(int index)
+void QmlViewCollectionModel::notifyElementsRemoved(int first, int last)
 {
-    if (index >= 0) {
-        beginRemoveRows(QModelIndex(), index, index);
+    if (first >= 0 && last >= 0) {
+        beginRemoveRows(QModelIndex(), first, last);
         endRemoveRows();
     }
 }
@@ -677,28 +786,190 @@ void QmlViewCollectionModel::notifyElementRemoved(int index)
 /*!
  * \brief QmlViewCollectionModel::notifyElementChanged
  * This notifies model subscribers that the element at the particular index
- * has been altered in some way.
- * \param index
+ * has been altered in some way. The notification is sent at the next turn of
+ * the event loop, together with the other ones queued meanwhile.
+ * \param index position in the backing view
  * \param role
  */
 void QmlViewCollectionModel::notifyElementChanged(int index, int role)
 {
-    if (index >= 0) {
-        QModelIndex model_index = createIndex(index, role);
-        emit dataChanged(model_index, model_index);
+    if (m_view != NULL && index >= 0)
+        queueElementChanged(m_view->getAt(index), role);
+}
+
+/*!
+ * \brief QmlViewCollectionModel::notifyRangeChanged notifies model subscribers
+ * right away that the role of the elements in a range of the backing view
+ * changed, with one dataChanged() for the rows of the range inside head and
+ * limit. Meant for changes reported as ranges already, like the selection.
+ * \param first
+ * \param last
+ * \param role
+ */
+void QmlViewCollectionModel::notifyRangeChanged(int first, int last, int role)
+{
+    // While batching, the positions in the view may not be rows yet; the
+    // objects are mapped to rows once the flush comes
+    if (m_view->isBatching()) {
+        for (int index = first; index <= last; ++index)
+            queueElementChanged(m_view->getAt(index), role);
+
+        return;
     }
+
+    int start = windowStart(m_view->count());
+    int first_row = qMax(first - start, 0);
+    int last_row = qMin(last - start, count() - 1);
+    if (first_row > last_row)
+        return;
+
+    QVector<int> roles;
+    roles.append(role);
+    emit dataChanged(index(first_row), index(last_row), roles);
 }
 
 /*!
- * \brief QmlViewCollectionModel::notifySetChanged
- * \param list
+ * \brief QmlViewCollectionModel::queueElementChanged records that the role of
+ * the object changed, and schedules flushElementChanges() if not yet done.
+ * Objects are queued rather than positions, as the view may be changed before
+ * the flush.
+ * \param object
  * \param role
  */
-void QmlViewCollectionModel::notifySetChanged(const QSet<DataObject*>* list, int role)
+void QmlViewCollectionModel::queueElementChanged(DataObject* object, int role)
+{
+    if (object == NULL)
+        return;
+
+    QVector<int>& roles = m_changedRoles[object];
+    QVector<int>::iterator it = std::lower_bound(roles.begin(), roles.end(), role);
+    if (it == roles.end() || *it != role)
+        roles.insert(it, role);
+
+    if (!m_flushScheduled) {
+        m_flushScheduled = true;
+        QMetaObject::invokeMethod(this, "flushElementChanges", Qt::QueuedConnection);
+    }
+}
+
+/*!
+ * \brief QmlViewCollectionModel::flushElementChanges emits a single
+ * dataChanged() for each run of consecutive rows whose objects had the same
+ * roles changed since the last flush
+ */
+void QmlViewCollectionModel::flushElementChanges()
+{
+    m_flushScheduled = false;
+
+    QHash<DataObject*, QVector<int> > changed;
+    changed.swap(m_changedRoles);
+    if (m_view == NULL || changed.isEmpty())
+        return;
+
+    // map the objects to the rows inside head and limit, sorted
+    int start = windowStart(m_view->count());
+    int rows = count();
+    QMap<int, QVector<int> > changedRows;
+    QHash<DataObject*, QVector<int> >::const_iterator object;
+    for (object = changed.constBegin(); object != changed.constEnd(); ++object) {
+        int position = m_view->indexOf(object.key());
+        if (position < 0)
+            continue;
+
+        int row = position - start;
+        if (row >= 0 && row < rows)
+            changedRows.insert(row, object.value());
+    }
+
+    QMap<int, QVector<int> >::const_iterator row = changedRows.constBegin();
+    while (row != changedRows.constEnd()) {
+        int first = row.key();
+        int last = first;
+        QVector<int> roles = row.value();
+        for (++row; row != changedRows.constEnd() && row.key() == last + 1
+             && row.value() == roles; ++row)
+            ++last;
+
+        emit dataChanged(index(first), index(last), roles);
+    }
+}
+
+/*!
+ * \brief QmlViewCollectionModel::windowStart
+ * \param count the number of objects in the backing view
+ * \return the position in the backing view of the first row, given head; a
+ * negative head means to start that many objects from the tail
+ */
+int QmlViewCollectionModel::windowStart(int count) const
+{
+    return (m_head >= 0) ? m_head : qMax(count + m_head, 0);
+}
+
+/*!
+ * \brief QmlViewCollectionModel::windowCount
+ * \param count the number of objects in the backing view
+ * \return the number of rows, given head and limit
+ */
+int QmlViewCollectionModel::windowCount(int count) const
+{
+    int available = qMax(count - windowStart(count), 0);
+
+    return (m_limit >= 0) ? qMin(available, m_limit) : available;
+}
+
+/*!
+ * \brief QmlViewCollectionModel::windowPositions
+ * \return the position in the backing view of each row
+ */
+QVector<int> QmlViewCollectionModel::windowPositions() const
+{
+    int start = windowStart(rawCount());
+    QVector<int> positions;
+    for (int row = 0; row < count(); ++row)
+        positions.append(start + row);
+
+    return positions;
+}
+
+/*!
+ * \brief QmlViewCollectionModel::notifyWindowChanged tells model subscribers
+ * which rows left and entered the window set by head and limit after it, or
+ * the backing view, changed. The objects staying in the window keep their
+ * relative order, so nothing needs to be moved.
+ * \param positions the position in the backing view, after the change, of
+ * each row from before it; -1 if no longer in the view
+ */
+void QmlViewCollectionModel::notifyWindowChanged(const QVector<int>& positions)
 {
-    DataObject* object;
-    foreach (object, *list)
-        notifyElementChanged(m_view->indexOf(object), role);
+    int start = windowStart(rawCount());
+    int rows = count();
+
+    QVector<bool> staying(rows, false);
+    QList<int> leaving;
+    for (int row = 0; row < positions.count(); ++row) {
+        int new_row = positions.at(row) - start;
+        if (positions.at(row) >= 0 && new_row >= 0 && new_row < rows)
+            staying[new_row] = true;
+        else
+            leaving.append(row);
+    }
+
+    // descending, so the rows before are still where they were
+    QList<IndexRange> ranges = DataCollection::toRanges(leaving);
+    for (int i = ranges.count() - 1; i >= 0; --i)
+        notifyElementsRemoved(ranges.at(i).first, ranges.at(i).last);
+
+    QList<int> entering;
+    for (int row = 0; row < rows; ++row) {
+        if (!staying.at(row))
+            entering.append(row);
+    }
+
+    // ascending, so each range goes in after the ones before it
+    ranges = DataCollection::toRanges(entering);
+    IndexRange range;
+    foreach (range, ranges)
+        notifyElementsAdded(range.first, range.last);
 }
 
 /*!
@@ -710,6 +981,39 @@ void QmlViewCollectionModel::notifyReset()
     endResetModel();
 }
 
+/*!
+ * \brief QmlViewCollectionModel::addRole names a role of a subclass
+ * \param role
+ * \param name
+ */
+void QmlViewCollectionModel::addRole(int role, const QByteArray& name)
+{
+    m_roles.insert(role, name);
+}
+
+/*!
+ * \brief QmlViewCollectionModel::dataForRole
+ * \param object
+ * \param role
+ * \return an invalid QVariant, there are no roles besides the common ones
+ */
+QVariant QmlViewCollectionModel::dataForRole(DataObject* object, int role) const
+{
+    Q_UNUSED(object);
+    Q_UNUSED(role);
+
+    return QVariant();
+}
+
+/*!
+ * \brief QmlViewCollectionModel::prefetch
+ * \param objects
+ */
+void QmlViewCollectionModel::prefetch(const QList<DataObject*>& objects)
+{
+    Q_UNUSED(objects);
+}
+
 /*!
  * \brief QmlViewCollectionModel::roleNames
  * \return
@@ -720,158 +1024,155 @@ QHash<int, QByteArray> QmlViewCollectionModel::roleNames() const
 }
 
 /*!
- * \brief QmlViewCollectionModel::onSelectionChanged
+ * \brief QmlViewCollectionModel::onSelectionRangesChanged
+ * \param ranges
  * \param selected
- * \param unselected
  */
-void QmlViewCollectionModel::onSelectionChanged(const QSet<DataObject*>* selected,
-                                                  const QSet<DataObject*>* unselected)
+void QmlViewCollectionModel::onSelectionRangesChanged(const QList<IndexRange>* ranges,
+                                                      bool selected)
 {
-    if (selected != NULL)
-        notifySetChanged(selected, SelectionRole);
+    Q_UNUSED(selected);
 
-    if (unselected != NULL)
-        notifySetChanged(unselected, SelectionRole);
+    IndexRange range;
+    foreach (range, *ranges)
+        notifyRangeChanged(range.first, range.last, SelectionRole);
 
     emit selectionChanged();
     emit selectedCountChanged();
 }
 
 /*!
- * \brief QmlViewCollectionModel::onContentsAboutToBeChanged
- * \param added
- * \param removed
+ * \brief QmlViewCollectionModel::onRangesInserted
+ * \param ranges
  */
-void QmlViewCollectionModel::onContentsAboutToBeChanged(const QSet<DataObject*>* added,
-                                                       const QSet<DataObject*>* removed)
+void QmlViewCollectionModel::onRangesInserted(const QList<IndexRange>* ranges)
 {
-    // Gather the indexes of all the elements to be removed before removal,
-    // then report their removal when they've actually been removed
-    if (removed != NULL) {
-        // should already be cleared; either first use or cleared in on_contents_altered()
-        Q_ASSERT(m_toBeRemoved.count() == 0);
-        DataObject* object;
-        foreach (object, *removed) {
-            int index = m_view->indexOf(object);
-            Q_ASSERT(index >= 0);
-            m_toBeRemoved.append(index);
+    // Only if we aren't getting a sub-view do we directly map these up to QML.
+    if (m_head == 0 && m_limit < 0) {
+        // ascending, so each range is added in the right place inside the
+        // "virtual" list held by QAbstractListModel
+        IndexRange range;
+        foreach (range, *ranges)
+            notifyElementsAdded(range.first, range.last);
+
+        foreach (range, *ranges) {
+            for (int index = range.first; index <= range.last; ++index)
+                Q_EMIT(indexAdded(index));
+        }
+    } else {
+        // Where the objects shown before the insertion are now: each one moved
+        // by the number of objects inserted in front of it
+        int inserted = 0;
+        IndexRange range;
+        foreach (range, *ranges)
+            inserted += range.count();
+
+        int old_count = rawCount() - inserted;
+        int old_start = windowStart(old_count);
+        QVector<int> positions;
+        int shift = 0;
+        int next = 0;
+        for (int position = old_start; position < old_start + windowCount(old_count); ++position) {
+            while (next < ranges->count() && ranges->at(next).first <= position + shift)
+                shift += ranges->at(next++).count();
+            positions.append(position + shift);
         }
+
+        notifyWindowChanged(positions);
     }
+
+    emit rawCountChanged();
+    emit countChanged();
 }
 
 /*!
- * \brief QmlViewCollectionModel::onContentsChanged
- * \param added
- * \param removed
+ * \brief QmlViewCollectionModel::onRangesRemoved
+ * \param ranges
+ * \param notify
  */
-void QmlViewCollectionModel::onContentsChanged(const QSet<DataObject*>* added,
-                                                 const QSet<DataObject*>* removed,
-                                                 bool notify)
+void QmlViewCollectionModel::onRangesRemoved(const QList<IndexRange>* ranges, bool notify)
 {
-    // Report removed items using indices gathered from on_contents_to_be_altered()
-    if (m_toBeRemoved.count() > 0) {
-        if (notify) {
-            // sort indices in reverse order and walk in descending order so they're
-            // always accurate as items are "removed"
-            qSort(m_toBeRemoved.begin(), m_toBeRemoved.end(), intReverseLessThan);
-
-            // Only if we aren't getting a sub-view do we directly map these up to QML.
-            if (m_head == 0 && m_limit < 0) {
-                int index;
-                foreach (index, m_toBeRemoved)
-                    notifyElementRemoved(index);
-            }
-
-            m_toBeRemoved.clear();
-        } else {
-            //FIXME We are doing a notifyReset since we are facing model corruption after
-            // some deletes on the Events tab
-            m_toBeRemoved.clear();
-            notifyReset();
-        }
-    }
-
-    // Report inserted items after they've been inserted
-    // Again, don't map directly to QML if we're only getting a sub-view.
-    if (added != NULL && m_head == 0 && m_limit < 0) {
-        // sort the indices in ascending order so each element is added in the
-        // right place inside the "virtual" list held by QAbstractListModel
-        QList<int> indices;
-
-        DataObject* object;
-        foreach (object, *added) {
-            indices.append(m_view->indexOf(object));
+    if (!notify) {
+        //FIXME We are doing a notifyReset since we are facing model corruption after
+        // some deletes on the Events tab
+        notifyReset();
+    } else if (m_head == 0 && m_limit < 0) {
+        // walk in descending order so the positions are always accurate as
+        // ranges are "removed"
+        for (int i = ranges->count() - 1; i >= 0; --i)
+            notifyElementsRemoved(ranges->at(i).first, ranges->at(i).last);
+    } else {
+        // Where the objects shown before the removal are now, if still there
+        int removed = 0;
+        IndexRange range;
+        foreach (range, *ranges)
+            removed += range.count();
+
+        int old_count = rawCount() + removed;
+        int old_start = windowStart(old_count);
+        QVector<int> positions;
+        int shift = 0;
+        int next = 0;
+        for (int position = old_start; position < old_start + windowCount(old_count); ++position) {
+            while (next < ranges->count() && ranges->at(next).last < position)
+                shift += ranges->at(next++).count();
+
+            if (next < ranges->count() && ranges->at(next).first <= position)
+                positions.append(-1);
+            else
+                positions.append(position - shift);
         }
 
-        qSort(indices.begin(), indices.end(), intLessThan);
-
-        if (!indices.isEmpty()) {
-            int index;
-            int head = -1;
-            int tail = -1;
-
-            // Notify each contiguos interval of indices
-            foreach (index, indices) {
-                if (head < 0) {
-                    head = index;
-                    tail = index;
-                } else {
-                    if (index == tail + 1) {
-                        tail = index;
-                    } else {
-                        notifyElementsAdded(head, tail);
-                        head = index;
-                        tail = index;
-                    }
-                }
-            }
-
-            notifyElementsAdded(head, tail);
-
-            foreach (index, indices) {
-                Q_EMIT(indexAdded(index));
-            }
-        }
+        notifyWindowChanged(positions);
     }
 
-    // TODO: "filtered" views get some special treatment.  Instead of figuring
-    // out how each addition/deletion affects it, we just wipe the whole thing
-    // out each time it's altered.  This is probably wasteful.
-    if (m_head != 0 || m_limit >= 0)
-        notifyReset();
-
     emit rawCountChanged();
     emit countChanged();
 }
 
 /*!
- * \brief QmlViewCollectionModel::onOrderingChanged
+ * \brief QmlViewCollectionModel::onOrderingAboutToBeChanged remembers which
+ * object each persistent index points to, so they can follow their objects
+ * once reordered
  */
-void QmlViewCollectionModel::onOrderingChanged()
+void QmlViewCollectionModel::onOrderingAboutToBeChanged()
 {
-    notifyReset();
+    // Sub-views are reset instead, see onOrderingChanged()
+    if (m_head != 0 || m_limit >= 0)
+        return;
 
-    emit orderingChanged();
-}
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(),
+                                QAbstractItemModel::VerticalSortHint);
 
-/*!
- * \brief QmlViewCollectionModel::intLessThan
- * \param a
- * \param b
- * \return
- */
-bool QmlViewCollectionModel::intLessThan(int a, int b)
-{
-    return a < b;
+    m_persistentObjects.clear();
+    QModelIndex index;
+    foreach (index, persistentIndexList())
+        m_persistentObjects.append(m_view->getAt(index.row()));
 }
 
 /*!
- * \brief QmlViewCollectionModel::intReverseLessThan
- * \param a
- * \param b
- * \return
+ * \brief QmlViewCollectionModel::onOrderingChanged reports the new order as a
+ * layout change, which lets the views keep their delegates
  */
-bool QmlViewCollectionModel::intReverseLessThan(int a, int b)
+void QmlViewCollectionModel::onOrderingChanged()
 {
-    return b < a;
+    if (m_head != 0 || m_limit >= 0) {
+        // Which objects are in the window changes too
+        notifyReset();
+    } else {
+        QModelIndexList from = persistentIndexList();
+        QModelIndexList to;
+        for (int i = 0; i < from.count(); ++i) {
+            DataObject* object = m_persistentObjects.value(i, NULL);
+            int row = (object != NULL) ? m_view->indexOf(object) : -1;
+            to.append((row >= 0) ? index(row, from.at(i).column()) : QModelIndex());
+        }
+        changePersistentIndexList(from, to);
+        m_persistentObjects.clear();
+
+        emit layoutChanged(QList<QPersistentModelIndex>(),
+                           QAbstractItemModel::VerticalSortHint);
+    }
+
+    emit orderingChanged();
 }
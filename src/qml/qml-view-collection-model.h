@@ -72,14 +72,12 @@ signals:
     void indexAdded(int index);
 
 public:
-    // These roles are available for all subclasses of QmlViewCollectionModel.
-    // However, they must be manually added (and named) in the QHash that's
-    // passed to Init(); they will not be added automatically.  However, if they
-    // are present in the QHash, QmlViewCollectionModel will automatically
-    // handle them; subclasses don't need to account for them in DataForRole().
+    // These roles are available for all subclasses of QmlViewCollectionModel,
+    // which handles them; subclasses don't need to account for them in
+    // dataForRole().
     //
     // Subclasses should start their numbering with LastCommonRole to avoid
-    // conflict.
+    // conflict, and name their roles with addRole().
     enum CommonRole {
         SelectionRole = Qt::UserRole + 1,
         ObjectRole,
@@ -104,8 +102,11 @@ public:
     Q_INVOKABLE void add(const QVariant &var);
     Q_INVOKABLE void selectAll();
     Q_INVOKABLE void unselectAll();
+    Q_INVOKABLE void selectRange(int first, int last);
+    Q_INVOKABLE void unselectRange(int first, int last);
     Q_INVOKABLE void toggleSelection(const QVariant &var);
     Q_INVOKABLE bool isSelected(const QVariant &var) const;
+    Q_INVOKABLE void setVisibleRange(int first, int last, int direction);
 
     virtual int rowCount(const QModelIndex& parent) const;
     virtual QVariant data(const QModelIndex& index, int role) const;
@@ -123,12 +124,14 @@ public:
 
     QList<MediaSource*> selectedMedias() const;
     QVariantList selectedMediasQML() const;
+    Q_INVOKABLE QVariantList selectedPage(int offset, int limit) const;
 
     SelectableViewCollection* backingViewCollection() const;
 
     DataObjectComparator defaultComparator() const;
     void setDefaultComparator(DataObjectComparator comparator);
     bool isAccepted(DataObject* item);
+    bool isAcceptingAll() const;
 
 protected:
     virtual void notifyBackingCollectionChanged();
@@ -147,39 +150,53 @@ protected:
     virtual DataObject* fromVariant(QVariant var) const = 0;
 
     void notifyElementsAdded(int first, int last);
-    void notifyElementRemoved(int index);
+    void notifyElementsRemoved(int first, int last);
     void notifyElementChanged(int index, int role);
     void notifyReset();
 
+    void addRole(int role, const QByteArray& name);
     virtual QHash<int, QByteArray> roleNames() const;
 
+    // Subclasses should return the value of their own roles for the object
+    virtual QVariant dataForRole(DataObject* object, int role) const;
+
+    // Subclasses may get data of the objects ahead of them being shown; the
+    // objects replace those passed before, most wanted first
+    virtual void prefetch(const QList<DataObject*>& objects);
+
 private slots:
-    void onSelectionChanged(const QSet<DataObject*>* selected,
-                            const QSet<DataObject*>* unselected);
-    void onContentsAboutToBeChanged(const QSet<DataObject*>* added,
-                                    const QSet<DataObject*>* removed);
-    void onContentsChanged(const QSet<DataObject*>* add,
-                             const QSet<DataObject*>* removed,
-                             bool notify);
+    void onSelectionRangesChanged(const QList<IndexRange>* ranges, bool selected);
+    void onRangesInserted(const QList<IndexRange>* ranges);
+    void onRangesRemoved(const QList<IndexRange>* ranges, bool notify);
+    void onOrderingAboutToBeChanged();
     void onOrderingChanged();
+    void flushElementChanges();
 
 private:
     QVariant m_collection;
     QVariant m_monitorSelection;
     SelectableViewCollection* m_view;
-    QList<int> m_toBeRemoved;
     DataObjectComparator m_defaultComparator;
     int m_head;
     int m_limit;
     QHash<int, QByteArray> m_roles;
+    // TypeNameRole for each type returned by toVariant()
+    mutable QHash<int, QVariant> m_typeNames;
     MediaSource::MediaType m_mediaTypeFilter;
-
-    static bool intLessThan(int a, int b);
-    static bool intReverseLessThan(int a, int b);
+    // Objects at the persistent indexes while the view is being reordered
+    QList<DataObject*> m_persistentObjects;
+    // Roles changed per object since the last flushElementChanges(), sorted
+    QHash<DataObject*, QVector<int> > m_changedRoles;
+    bool m_flushScheduled;
 
     void setBackingViewCollection(SelectableViewCollection* view);
     void disconnectBackingViewCollection();
-    void notifySetChanged(const QSet<DataObject*> *list, int role);
+    void notifyRangeChanged(int first, int last, int role);
+    void queueElementChanged(DataObject* object, int role);
+    int windowStart(int count) const;
+    int windowCount(int count) const;
+    QVector<int> windowPositions() const;
+    void notifyWindowChanged(const QVector<int>& positions);
 };
 
 #endif  // GALLERY_QML_VIEW_COLLECTION_MODEL_H_
@@ -35,6 +35,7 @@ CommandLineParser::CommandLineParser(const QHash<QString, QSize>& form_factors)
       m_picturesDir(""),
       m_pickMode(false),
       m_logImageLoading(false),
+      m_profileSql(false),
       m_formFactors(form_factors),
       m_formFactor("desktop"),
       m_mediaFile("")
@@ -74,6 +75,9 @@ bool CommandLineParser::processArguments(const QStringList& args)
         else if (args[i] == "--log-image-loading") {
             m_logImageLoading = true;
         }
+        else if (args[i] == "--profile-sql") {
+            m_profileSql = true;
+        }
         else if (args[i] == "--pick-mode") {
             m_pickMode = true;
         }
@@ -138,6 +142,7 @@ void CommandLineParser::usage()
 
     out << "  --startup-timer\n\t\tdebug-print startup time" << endl;
     out << "  --log-image-loading\n\t\tlog image loading" << endl;
+    out << "  --profile-sql\n\t\tlog slow SQL statements and print SQL timings on exit" << endl;
     out << "  --pick-mode\n\t\tEnable mode to pick photos" << endl;
     out << "  --media-file FILE\n\t\tOpens gallery displaying the selected file" << endl;
     out << "pictures_dir defaults to ~/Pictures, and must exist prior to running gallery" << endl;
@@ -44,6 +44,7 @@ public:
     bool startupTimer() const { return m_startupTimer; }
     bool logImageLoading() const { return m_logImageLoading; }
     bool pickModeEnabled() const { return m_pickMode; }
+    bool profileSql() const { return m_profileSql; }
     const QString &formFactor() const { return m_formFactor; }
     const QString &mediaFile() const { return m_mediaFile; }
 
@@ -58,6 +59,7 @@ private:
     QString m_picturesDir;
     bool m_pickMode;
     bool m_logImageLoading;
+    bool m_profileSql;
 
     const QHash<QString, QSize> m_formFactors;
     QString m_formFactor;
@@ -37,6 +37,7 @@ private slots:
     void is_fullscreen_test();
     void startup_timer_test();
     void log_image_loading_test();
+    void profile_sql_test();
 
     void process_args_test();
     void process_args_test_data();
@@ -80,6 +81,13 @@ void tst_CommandLineParser::log_image_loading_test()
     QCOMPARE(cmd_line_parser_->logImageLoading(), expect);
 }
 
+void tst_CommandLineParser::profile_sql_test()
+{
+    bool expect = false;
+
+    QCOMPARE(cmd_line_parser_->profileSql(), expect);
+}
+
 void tst_CommandLineParser::process_args_test_data()
 {
     QTest::addColumn<QStringList>("process_args");
@@ -88,6 +96,7 @@ void tst_CommandLineParser::process_args_test_data()
     QTest::addColumn<bool>("startup_timer");
     QTest::addColumn<bool>("log_image_loading");
     QTest::addColumn<bool>("pick_mode_enabled");
+    QTest::addColumn<bool>("profile_sql");
     QTest::addColumn<bool>("invalid_arg");
 
     QStringList boolean_test;
@@ -97,6 +106,7 @@ void tst_CommandLineParser::process_args_test_data()
     boolean_test.append("--startup-timer");
     boolean_test.append("--log-image-loading");
     boolean_test.append("--pick-mode");
+    boolean_test.append("--profile-sql");
 
     QStringList invalid_arg_test;
     invalid_arg_test.append("gallery");
@@ -108,11 +118,11 @@ void tst_CommandLineParser::process_args_test_data()
     help_test.append("--landscape");
 
     QTest::newRow("Boolean member test") << boolean_test << true << true << true << true
-                                         << true << true;
+                                         << true << true << true;
     QTest::newRow("Invalid arg test") << invalid_arg_test << false << false << false << false
-                                      << false << false;
+                                      << false << false << false;
     QTest::newRow("Help test") << help_test << false << false << false << false
-                               << false << false;
+                               << false << false << false;
 }
 
 void tst_CommandLineParser::process_args_test()
@@ -127,6 +137,7 @@ void tst_CommandLineParser::process_args_test()
     QFETCH(bool, startup_timer);
     QFETCH(bool, log_image_loading);
     QFETCH(bool, pick_mode_enabled);
+    QFETCH(bool, profile_sql);
     QFETCH(bool, invalid_arg);
 
     bool result = test.processArguments(process_args);
@@ -136,6 +147,7 @@ void tst_CommandLineParser::process_args_test()
     QCOMPARE(test.startupTimer(), startup_timer);
     QCOMPARE(test.logImageLoading(), log_image_loading);
     QCOMPARE(test.pickModeEnabled(), pick_mode_enabled);
+    QCOMPARE(test.profileSql(), profile_sql);
     QCOMPARE(result, invalid_arg);
 }
 
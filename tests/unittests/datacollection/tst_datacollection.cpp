@@ -0,0 +1,667 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <QtTest/QtTest>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "data-collection.h"
+#include "data-object.h"
+#include "selectable-view-collection.h"
+#include "view-collection.h"
+
+/*!
+ * \brief The ValueObject class is a DataObject ordered by a value, which many
+ * objects may share
+ */
+class ValueObject : public DataObject
+{
+    Q_OBJECT
+
+public:
+    ValueObject(int value) : DataObject(), m_value(value) {}
+
+    int value() const { return m_value; }
+
+private:
+    int m_value;
+};
+
+static int valueOf(DataObject* object)
+{
+    return qobject_cast<ValueObject*>(object)->value();
+}
+
+// Ties are broken by descending number, so that the descending order is the
+// exact reverse
+static DataObjectKey valueAscendingKey(DataObject* object)
+{
+    return DataObjectKey(valueOf(object), -object->number());
+}
+
+static DataObjectKey valueDescendingKey(DataObject* object)
+{
+    return DataObjectKey(-valueOf(object), object->number());
+}
+
+static bool valueAscendingComparator(DataObject* a, DataObject* b)
+{
+    return valueAscendingKey(a) < valueAscendingKey(b);
+}
+
+static bool valueDescendingComparator(DataObject* a, DataObject* b)
+{
+    return valueDescendingKey(a) < valueDescendingKey(b);
+}
+
+// Same order as valueDescendingComparator, without a sort key registered
+static bool unkeyedDescendingComparator(DataObject* a, DataObject* b)
+{
+    return valueOf(a) > valueOf(b)
+            || (valueOf(a) == valueOf(b) && a->number() < b->number());
+}
+
+static const bool comparatorsRegistered =
+        DataCollection::registerSortKey(valueAscendingComparator, valueAscendingKey)
+        && DataCollection::registerSortKey(valueDescendingComparator, valueDescendingKey)
+        && DataCollection::registerInverseComparators(valueAscendingComparator,
+                                                      valueDescendingComparator);
+
+static QString rangesToString(const QList<IndexRange>& ranges)
+{
+    QStringList parts;
+    IndexRange range;
+    foreach (range, ranges)
+        parts.append(QString("%1-%2").arg(range.first).arg(range.last));
+
+    return parts.join(",");
+}
+
+/*!
+ * \brief The RangeRecorder class records the index ranges a DataCollection
+ * reports, with the objects found at those positions when they were reported
+ */
+class RangeRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    RangeRecorder(DataCollection* collection)
+        : QObject(), m_collection(collection), contentsChangedCount(0)
+    {
+        QObject::connect(collection, SIGNAL(rangesInserted(const QList<IndexRange>*)),
+                         this, SLOT(onRangesInserted(const QList<IndexRange>*)));
+        QObject::connect(collection, SIGNAL(rangesAboutToBeRemoved(const QList<IndexRange>*)),
+                         this, SLOT(onRangesAboutToBeRemoved(const QList<IndexRange>*)));
+        QObject::connect(collection, SIGNAL(rangesRemoved(const QList<IndexRange>*, bool)),
+                         this, SLOT(onRangesRemoved(const QList<IndexRange>*, bool)));
+        QObject::connect(collection,
+                         SIGNAL(contentsChanged(const QSet<DataObject*>*, const QSet<DataObject*>*, bool)),
+                         this,
+                         SLOT(onContentsChanged(const QSet<DataObject*>*, const QSet<DataObject*>*, bool)));
+    }
+
+    QStringList inserted;
+    QStringList aboutToBeRemoved;
+    QStringList removed;
+    QSet<DataObject*> insertedObjects;
+    QSet<DataObject*> aboutToBeRemovedObjects;
+    QSet<DataObject*> added;
+    QSet<DataObject*> lost;
+    int contentsChangedCount;
+
+private slots:
+    void onRangesInserted(const QList<IndexRange>* ranges) {
+        inserted.append(rangesToString(*ranges));
+        insertedObjects.unite(objectsAt(*ranges));
+    }
+
+    void onRangesAboutToBeRemoved(const QList<IndexRange>* ranges) {
+        aboutToBeRemoved.append(rangesToString(*ranges));
+        aboutToBeRemovedObjects.unite(objectsAt(*ranges));
+    }
+
+    void onRangesRemoved(const QList<IndexRange>* ranges, bool notify) {
+        Q_UNUSED(notify);
+        removed.append(rangesToString(*ranges));
+    }
+
+    void onContentsChanged(const QSet<DataObject*>* addedObjects,
+                           const QSet<DataObject*>* removedObjects, bool notify) {
+        Q_UNUSED(notify);
+        ++contentsChangedCount;
+        if (addedObjects != NULL)
+            added.unite(*addedObjects);
+        if (removedObjects != NULL)
+            lost.unite(*removedObjects);
+    }
+
+private:
+    QSet<DataObject*> objectsAt(const QList<IndexRange>& ranges) const {
+        QSet<DataObject*> objects;
+        IndexRange range;
+        foreach (range, ranges) {
+            for (int index = range.first; index <= range.last; ++index)
+                objects.insert(m_collection->getAt(index));
+        }
+
+        return objects;
+    }
+
+    DataCollection* m_collection;
+};
+
+/*!
+ * \brief The SelectionRecorder class records the selection ranges a
+ * SelectableViewCollection reports
+ */
+class SelectionRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    SelectionRecorder(SelectableViewCollection* collection) : QObject()
+    {
+        QObject::connect(collection, SIGNAL(selectionRangesChanged(const QList<IndexRange>*, bool)),
+                         this, SLOT(onSelectionRangesChanged(const QList<IndexRange>*, bool)));
+    }
+
+    QStringList selected;
+    QStringList unselected;
+
+private slots:
+    void onSelectionRangesChanged(const QList<IndexRange>* ranges, bool isSelected) {
+        if (isSelected)
+            selected.append(rangesToString(*ranges));
+        else
+            unselected.append(rangesToString(*ranges));
+    }
+};
+
+class tst_DataCollection : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void order_data();
+    void order();
+    void indexOf();
+    void rangesInserted();
+    void rangesRemoved();
+    void batchNetChanges();
+    void batchWithoutNetChanges();
+    void reverseMatchesResort();
+    void mirrorAcrossBatch();
+    void selectionRanges();
+    void selectionAcrossInsert();
+    void selectionAcrossRemove();
+    void selectionAcrossReorder();
+    void selectionAcrossBatch();
+
+private:
+    ValueObject* create(int value);
+    QList<DataObject*> createMany(const QList<int>& values);
+    void checkOrder(const DataCollection& collection);
+    void checkSelection(const SelectableViewCollection& collection,
+                        const QSet<DataObject*>& expected);
+
+    QList<DataObject*> m_objects;
+};
+
+void tst_DataCollection::init()
+{
+    QVERIFY(comparatorsRegistered);
+}
+
+void tst_DataCollection::cleanup()
+{
+    qDeleteAll(m_objects);
+    m_objects.clear();
+}
+
+ValueObject* tst_DataCollection::create(int value)
+{
+    ValueObject* object = new ValueObject(value);
+    m_objects.append(object);
+
+    return object;
+}
+
+QList<DataObject*> tst_DataCollection::createMany(const QList<int>& values)
+{
+    QList<DataObject*> objects;
+    int value;
+    foreach (value, values)
+        objects.append(create(value));
+
+    return objects;
+}
+
+void tst_DataCollection::checkOrder(const DataCollection& collection)
+{
+    const QList<DataObject*>& all = collection.getAll();
+    DataObjectComparator comparator = collection.comparator();
+    for (int i = 1; i < all.count(); ++i)
+        QVERIFY(!comparator(all.at(i), all.at(i - 1)));
+}
+
+void tst_DataCollection::checkSelection(const SelectableViewCollection& collection,
+                                        const QSet<DataObject*>& expected)
+{
+    QCOMPARE(collection.selectedCount(), expected.count());
+    QCOMPARE(collection.getSelected(), expected);
+    for (int index = 0; index < collection.count(); ++index)
+        QCOMPARE(collection.isSelectedAt(index), expected.contains(collection.getAt(index)));
+}
+
+void tst_DataCollection::order_data()
+{
+    QTest::addColumn<bool>("bulk");
+    QTest::addColumn<bool>("keyed");
+
+    QTest::newRow("one by one, keyed") << false << true;
+    QTest::newRow("one by one, comparator") << false << false;
+    QTest::newRow("merged, keyed") << true << true;
+    QTest::newRow("merged, comparator") << true << false;
+}
+
+void tst_DataCollection::order()
+{
+    QFETCH(bool, bulk);
+    QFETCH(bool, keyed);
+
+    DataCollection collection("order");
+    collection.setComparator(keyed ? valueDescendingComparator : unkeyedDescendingComparator);
+
+    QList<DataObject*> objects = createMany(QList<int>() << 5 << 1 << 5 << 9 << 0
+                                            << 3 << 5 << 1 << 7 << 2 << 9 << 4);
+    if (bulk) {
+        collection.addMany(objects.mid(0, 4).toSet());
+        collection.addMany(objects.mid(4).toSet());
+    } else {
+        DataObject* object;
+        foreach (object, objects)
+            collection.add(object);
+    }
+
+    QCOMPARE(collection.count(), objects.count());
+    checkOrder(collection);
+
+    // Ties keep the order of their numbers
+    QCOMPARE(collection.getAt(0), objects.at(3));
+    QCOMPARE(collection.getAt(1), objects.at(10));
+    QCOMPARE(collection.getAt(3), objects.at(0));
+    QCOMPARE(collection.getAt(4), objects.at(2));
+    QCOMPARE(collection.getAt(5), objects.at(6));
+}
+
+void tst_DataCollection::indexOf()
+{
+    DataCollection collection("indexOf");
+    collection.setComparator(valueAscendingComparator);
+
+    QList<DataObject*> objects = createMany(QList<int>() << 2 << 2 << 2 << 1 << 3
+                                            << 2 << 1 << 3 << 2);
+    collection.addMany(objects.toSet());
+
+    for (int index = 0; index < collection.count(); ++index)
+        QCOMPARE(collection.indexOf(collection.getAt(index)), index);
+
+    QCOMPARE(collection.indexOf(create(2)), -1);
+
+    collection.remove(objects.at(1), true);
+    QCOMPARE(collection.indexOf(objects.at(1)), -1);
+    for (int index = 0; index < collection.count(); ++index)
+        QCOMPARE(collection.indexOf(collection.getAt(index)), index);
+}
+
+void tst_DataCollection::rangesInserted()
+{
+    DataCollection collection("rangesInserted");
+    collection.setComparator(valueAscendingComparator);
+    collection.addMany(createMany(QList<int>() << 0 << 2 << 4 << 6 << 8).toSet());
+
+    RangeRecorder recorder(&collection);
+
+    collection.add(create(5));
+    QCOMPARE(recorder.inserted, QStringList() << "3-3");
+
+    // 0 1 1 2 3 4 5 6 7 8 9, the 1s sort by descending number
+    QList<DataObject*> objects = createMany(QList<int>() << 1 << 1 << 3 << 7 << 9);
+    collection.addMany(objects.toSet());
+    QCOMPARE(recorder.inserted.last(), QString("1-2,4-4,8-8,10-10"));
+    QCOMPARE(recorder.insertedObjects, objects.toSet() << collection.getAt(6));
+
+    // Appended past the end without comparisons
+    QList<DataObject*> appended = createMany(QList<int>() << 10 << 11);
+    collection.appendSorted(appended);
+    QCOMPARE(recorder.inserted.last(), QString("11-12"));
+    QCOMPARE(collection.getAt(12), appended.at(1));
+
+    checkOrder(collection);
+    QCOMPARE(recorder.contentsChangedCount, 3);
+}
+
+void tst_DataCollection::rangesRemoved()
+{
+    DataCollection collection("rangesRemoved");
+    collection.setComparator(valueAscendingComparator);
+    QList<DataObject*> objects = createMany(QList<int>() << 0 << 1 << 2 << 3 << 4
+                                            << 5 << 6 << 7 << 8 << 9);
+    collection.addMany(objects.toSet());
+
+    RangeRecorder recorder(&collection);
+
+    QSet<DataObject*> toRemove;
+    toRemove << objects.at(1) << objects.at(2) << objects.at(5) << objects.at(9);
+    collection.removeMany(toRemove, true);
+
+    QCOMPARE(recorder.aboutToBeRemoved, QStringList() << "1-2,5-5,9-9");
+    QCOMPARE(recorder.removed, recorder.aboutToBeRemoved);
+    QCOMPARE(recorder.aboutToBeRemovedObjects, toRemove);
+    QCOMPARE(recorder.lost, toRemove);
+
+    QCOMPARE(collection.count(), 6);
+    QCOMPARE(collection.getAt(1), objects.at(3));
+    QCOMPARE(collection.getAt(3), objects.at(6));
+    QCOMPARE(collection.getAt(5), objects.at(8));
+
+    collection.clear();
+    QCOMPARE(recorder.removed.last(), QString("0-5"));
+    QCOMPARE(collection.count(), 0);
+}
+
+void tst_DataCollection::batchNetChanges()
+{
+    DataCollection collection("batchNetChanges");
+    collection.setComparator(valueAscendingComparator);
+    QList<DataObject*> objects = createMany(QList<int>() << 0 << 2 << 4 << 6 << 8);
+    collection.addMany(objects.toSet());
+
+    RangeRecorder recorder(&collection);
+
+    ValueObject* transient = create(5);
+    ValueObject* first = create(1);
+    ValueObject* last = create(9);
+
+    collection.beginBatch();
+    collection.add(transient);
+    collection.add(first);
+    collection.beginBatch();
+    collection.remove(objects.at(2), true);
+    collection.remove(transient, true);
+    collection.endBatch();
+    collection.add(last);
+    collection.remove(objects.at(0), true);
+    QCOMPARE(recorder.contentsChangedCount, 0);
+    QVERIFY(recorder.inserted.isEmpty());
+    QVERIFY(recorder.aboutToBeRemoved.isEmpty());
+    collection.endBatch();
+
+    // One change, from the contents the batch started with to the final ones
+    QCOMPARE(recorder.contentsChangedCount, 1);
+    QCOMPARE(recorder.added, QSet<DataObject*>() << first << last);
+    QCOMPARE(recorder.lost, QSet<DataObject*>() << objects.at(0) << objects.at(2));
+
+    // 0 2 4 6 8 -> 2 6 8, then 1 2 6 8 9
+    QCOMPARE(recorder.aboutToBeRemoved, QStringList() << "0-0,2-2");
+    QCOMPARE(recorder.removed, recorder.aboutToBeRemoved);
+    QCOMPARE(recorder.aboutToBeRemovedObjects, recorder.lost);
+    QCOMPARE(recorder.inserted, QStringList() << "0-0,4-4");
+    QCOMPARE(recorder.insertedObjects, recorder.added);
+
+    QCOMPARE(collection.count(), 5);
+    QCOMPARE(collection.indexOf(first), 0);
+    QCOMPARE(collection.indexOf(last), 4);
+    checkOrder(collection);
+}
+
+void tst_DataCollection::batchWithoutNetChanges()
+{
+    DataCollection collection("batchWithoutNetChanges");
+    QList<DataObject*> objects = createMany(QList<int>() << 0 << 1 << 2);
+    collection.addMany(objects.toSet());
+
+    RangeRecorder recorder(&collection);
+
+    collection.beginBatch();
+    ValueObject* transient = create(3);
+    collection.add(transient);
+    collection.remove(objects.at(1), true);
+    collection.remove(transient, true);
+    collection.add(objects.at(1));
+    QVERIFY(collection.isBatching());
+    collection.endBatch();
+
+    QVERIFY(!collection.isBatching());
+    QCOMPARE(recorder.contentsChangedCount, 0);
+    QVERIFY(recorder.inserted.isEmpty());
+    QVERIFY(recorder.removed.isEmpty());
+    QCOMPARE(collection.getAll(), objects);
+}
+
+void tst_DataCollection::reverseMatchesResort()
+{
+    QList<int> values = QList<int>() << 3 << 1 << 3 << 2 << 1 << 3 << 2 << 2 << 1 << 3;
+
+    // Reversed, as the comparators are registered as inverses
+    DataCollection reversed("reversed");
+    reversed.setComparator(valueAscendingComparator);
+    reversed.addMany(createMany(values).toSet());
+    QSet<DataObject*> objects = reversed.getAsSet();
+    reversed.setComparator(valueDescendingComparator);
+
+    // Resorted from the default order, by key and by comparator
+    DataCollection resortedByKey("resortedByKey");
+    resortedByKey.addMany(objects);
+    resortedByKey.setComparator(valueDescendingComparator);
+
+    DataCollection resorted("resorted");
+    resorted.addMany(objects);
+    resorted.setComparator(unkeyedDescendingComparator);
+
+    QCOMPARE(reversed.getAll(), resortedByKey.getAll());
+    QCOMPARE(reversed.getAll(), resorted.getAll());
+    checkOrder(reversed);
+
+    for (int index = 0; index < reversed.count(); ++index)
+        QCOMPARE(reversed.indexOf(reversed.getAt(index)), index);
+
+    // Back again
+    reversed.setComparator(valueAscendingComparator);
+    resorted.setComparator(valueAscendingComparator);
+    QCOMPARE(reversed.getAll(), resorted.getAll());
+}
+
+void tst_DataCollection::mirrorAcrossBatch()
+{
+    DataCollection collection("mirrored");
+    collection.setComparator(valueAscendingComparator);
+    QList<DataObject*> objects = createMany(QList<int>() << 0 << 2 << 4 << 6);
+    collection.addMany(objects.toSet());
+
+    ViewCollection mirror("mirror");
+    mirror.monitorDataCollection(&collection, NULL, true);
+    QVERIFY(mirror.isMirroring());
+    QCOMPARE(mirror.getAll(), collection.getAll());
+
+    // The mirror keeps the contents from before the batch until it ends, and
+    // its membership agrees with its positions meanwhile
+    ValueObject* added = create(3);
+    collection.beginBatch();
+    collection.add(added);
+    collection.remove(objects.at(1), true);
+    QVERIFY(!mirror.contains(added));
+    QCOMPARE(mirror.indexOf(added), -1);
+    QVERIFY(mirror.contains(objects.at(1)));
+    QCOMPARE(mirror.indexOf(objects.at(1)), 1);
+    QCOMPARE(mirror.count(), 4);
+    collection.endBatch();
+
+    QCOMPARE(mirror.getAll(), collection.getAll());
+    QCOMPARE(mirror.getAsSet(), collection.getAsSet());
+    QCOMPARE(mirror.indexOf(added), 1);
+    QVERIFY(!mirror.contains(objects.at(1)));
+}
+
+void tst_DataCollection::selectionRanges()
+{
+    SelectableViewCollection collection("selectionRanges");
+    collection.setComparator(valueAscendingComparator);
+    QList<DataObject*> objects = createMany(QList<int>() << 0 << 1 << 2 << 3 << 4
+                                            << 5 << 6 << 7);
+    collection.addMany(objects.toSet());
+
+    SelectionRecorder recorder(&collection);
+
+    QCOMPARE(collection.selectRange(2, 3), 2);
+    QCOMPARE(collection.selectRange(1, 5), 3);
+    QCOMPARE(recorder.selected, QStringList() << "2-3" << "1-1,4-5");
+
+    // Only the positions that changed are reported
+    QCOMPARE(collection.selectRange(2, 4), 0);
+    QCOMPARE(recorder.selected.count(), 2);
+
+    QCOMPARE(collection.unselectMany(QSet<DataObject*>() << objects.at(2) << objects.at(5)
+                                     << objects.at(7)), 2);
+    QCOMPARE(recorder.unselected, QStringList() << "2-2,5-5");
+
+    checkSelection(collection, QSet<DataObject*>() << objects.at(1) << objects.at(3)
+                   << objects.at(4));
+}
+
+void tst_DataCollection::selectionAcrossInsert()
+{
+    SelectableViewCollection collection("selectionAcrossInsert");
+    collection.setComparator(valueAscendingComparator);
+    QList<DataObject*> objects = createMany(QList<int>() << 0 << 2 << 4 << 6 << 8 << 10);
+    collection.addMany(objects.toSet());
+
+    QSet<DataObject*> selected;
+    selected << objects.at(0) << objects.at(2) << objects.at(3);
+    collection.selectMany(selected);
+    checkSelection(collection, selected);
+
+    // Between, before and after the selected objects
+    collection.add(create(5));
+    checkSelection(collection, selected);
+
+    collection.addMany(createMany(QList<int>() << -1 << 1 << 3 << 7 << 9 << 11 << 12
+                                  << 4).toSet());
+    checkSelection(collection, selected);
+    QCOMPARE(collection.count(), 15);
+
+    DataObject* added = create(13);
+    collection.add(added);
+    QVERIFY(collection.select(added));
+    checkSelection(collection, selected << added);
+}
+
+void tst_DataCollection::selectionAcrossRemove()
+{
+    SelectableViewCollection collection("selectionAcrossRemove");
+    collection.setComparator(valueAscendingComparator);
+    QList<DataObject*> objects = createMany(QList<int>() << 0 << 1 << 2 << 3 << 4
+                                            << 5 << 6 << 7 << 8 << 9);
+    collection.addMany(objects.toSet());
+
+    QSet<DataObject*> selected;
+    selected << objects.at(1) << objects.at(2) << objects.at(5) << objects.at(8);
+    collection.selectMany(selected);
+
+    collection.remove(objects.at(0), true);
+    checkSelection(collection, selected);
+
+    // Both selected and unselected objects
+    collection.removeMany(QSet<DataObject*>() << objects.at(2) << objects.at(3)
+                          << objects.at(6) << objects.at(8), true);
+    selected.remove(objects.at(2));
+    selected.remove(objects.at(8));
+    checkSelection(collection, selected);
+
+    collection.clear();
+    checkSelection(collection, QSet<DataObject*>());
+}
+
+void tst_DataCollection::selectionAcrossReorder()
+{
+    SelectableViewCollection collection("selectionAcrossReorder");
+    collection.setComparator(valueAscendingComparator);
+    QList<DataObject*> objects = createMany(QList<int>() << 3 << 1 << 3 << 2 << 1 << 2);
+    collection.addMany(objects.toSet());
+
+    QSet<DataObject*> selected;
+    selected << objects.at(0) << objects.at(3) << objects.at(4);
+    collection.selectMany(selected);
+
+    // Reversed
+    collection.setComparator(valueDescendingComparator);
+    checkSelection(collection, selected);
+
+    // Resorted
+    collection.setComparator(unkeyedDescendingComparator);
+    checkSelection(collection, selected);
+
+    collection.setComparator(valueAscendingComparator);
+    checkSelection(collection, selected);
+}
+
+void tst_DataCollection::selectionAcrossBatch()
+{
+    SelectableViewCollection collection("selectionAcrossBatch");
+    collection.setComparator(valueAscendingComparator);
+    QList<DataObject*> objects = createMany(QList<int>() << 0 << 2 << 4 << 6 << 8);
+    collection.addMany(objects.toSet());
+
+    QSet<DataObject*> selected;
+    selected << objects.at(1) << objects.at(3);
+    collection.selectMany(selected);
+
+    RangeRecorder recorder(&collection);
+
+    DataObject* unselectedAdd = create(1);
+    DataObject* selectedAdd = create(5);
+    collection.beginBatch();
+    collection.add(unselectedAdd);
+    collection.add(selectedAdd);
+    collection.select(selectedAdd);
+    collection.remove(objects.at(3), true);
+    collection.remove(objects.at(4), true);
+    collection.endBatch();
+
+    selected.remove(objects.at(3));
+    selected.insert(selectedAdd);
+    checkSelection(collection, selected);
+    QCOMPARE(recorder.contentsChangedCount, 1);
+
+    // Nothing selected while batching
+    collection.unselectAll();
+    collection.beginBatch();
+    collection.add(create(7));
+    collection.remove(objects.at(0), true);
+    collection.endBatch();
+    checkSelection(collection, QSet<DataObject*>());
+}
+
+QTEST_MAIN(tst_DataCollection)
+
+#include "tst_datacollection.moc"
@@ -48,6 +48,7 @@ private slots:
     void enableContentLoadFilter();
     void addPhoto();
     void addVideo();
+    void addMediaOutOfOrder();
 
 private:
     MediaSource* wait_for_media();
@@ -191,16 +192,20 @@ void tst_MediaObjectFactory::addPhoto()
     QDateTime timestamp(QDate(2013, 02, 03), QTime(12, 12, 12));
     QDateTime exposureTime(QDate(2013, 03, 04), QTime(1, 2, 3));
     Orientation originalOrientation(BOTTOM_RIGHT_ORIGIN);
-    qint64 filesize = 2048;
 
-    m_factory->addMedia(id, filename, size, timestamp,
-                        exposureTime, originalOrientation, filesize);
+    MediaRow row;
+    row.id = id;
+    row.filename = filename;
+    row.size = size;
+    row.timestamp = timestamp;
+    row.exposureTime = exposureTime;
+    row.originalOrientation = originalOrientation;
+    row.filesize = 2048;
+    m_factory->addMedia(row);
 
-    QCOMPARE(m_factory->m_mediaFromDB.size(), 1);
-    
-    QSet<DataObject*>::iterator it;
-    it = m_factory->m_mediaFromDB.begin();
-    DataObject *obj = *it;
+    QCOMPARE(m_factory->m_mediaFromDBChunk.size(), 1);
+
+    DataObject *obj = m_factory->m_mediaFromDBChunk.first();
     Photo *photo = qobject_cast<Photo*>(obj);
     QVERIFY(photo != 0);
 
@@ -226,19 +231,21 @@ void tst_MediaObjectFactory::addVideo()
     qint64 id = 123;
     QString filename(tmpDir->path() + "/sample/sample.mp4");
     QSize size(320, 200);
-    QDateTime timestamp(QDate(2013, 02, 03), QTime(12, 12, 12));
     QDateTime exposureTime(QDate(2013, 03, 04), QTime(1, 2, 3));
-    Orientation originalOrientation(BOTTOM_RIGHT_ORIGIN);
-    qint64 filesize = 2048;
 
-    m_factory->addMedia(id, filename, size, timestamp,
-                        exposureTime, originalOrientation, filesize);
+    MediaRow row;
+    row.id = id;
+    row.filename = filename;
+    row.size = size;
+    row.timestamp = QDateTime(QDate(2013, 02, 03), QTime(12, 12, 12));
+    row.exposureTime = exposureTime;
+    row.originalOrientation = BOTTOM_RIGHT_ORIGIN;
+    row.filesize = 2048;
+    m_factory->addMedia(row);
 
-    QCOMPARE(m_factory->m_mediaFromDB.size(), 1);
-    
-    QSet<DataObject*>::iterator it;
-    it = m_factory->m_mediaFromDB.begin();
-    DataObject *obj = *it;
+    QCOMPARE(m_factory->m_mediaFromDBChunk.size(), 1);
+
+    DataObject *obj = m_factory->m_mediaFromDBChunk.first();
     Video *video = qobject_cast<Video*>(obj);
     QVERIFY(video != 0);
 
@@ -248,6 +255,45 @@ void tst_MediaObjectFactory::addVideo()
     QCOMPARE(video->exposureDateTime(), exposureTime);
 }
 
+void tst_MediaObjectFactory::addMediaOutOfOrder()
+{
+    QTemporaryDir tmpDir;
+    QImage sampleImage(40, 60, QImage::Format_RGB32);
+    sampleImage.fill(QColor(Qt::red));
+    QString first(tmpDir.path() + "/first.jpg");
+    QString second(tmpDir.path() + "/second.jpg");
+    QString third(tmpDir.path() + "/third.jpg");
+    sampleImage.save(first, "JPG");
+    sampleImage.save(second, "JPG");
+    sampleImage.save(third, "JPG");
+
+    MediaRow row;
+    row.size = QSize(40, 60);
+    row.timestamp = QDateTime(QDate(2013, 02, 03), QTime(12, 12, 12));
+    row.filesize = 2048;
+
+    // rows arrive newest first ...
+    row.id = 1;
+    row.filename = first;
+    row.exposureTime = QDateTime(QDate(2013, 03, 04), QTime(1, 2, 3));
+    m_factory->addMedia(row);
+    row.id = 2;
+    row.filename = second;
+    row.exposureTime = QDateTime(QDate(2013, 03, 01), QTime(1, 2, 3));
+    m_factory->addMedia(row);
+    // ... except this one
+    row.id = 3;
+    row.filename = third;
+    row.exposureTime = QDateTime(QDate(2013, 03, 02), QTime(1, 2, 3));
+    m_factory->addMedia(row);
+
+    QCOMPARE(m_factory->m_mediaFromDBChunk.size(), 2);
+    QCOMPARE(qobject_cast<MediaSource*>(m_factory->m_mediaFromDBChunk.at(0))->id(), (qint64)1);
+    QCOMPARE(qobject_cast<MediaSource*>(m_factory->m_mediaFromDBChunk.at(1))->id(), (qint64)2);
+    QCOMPARE(m_factory->m_mediaFromDB.size(), 1);
+    QCOMPARE(qobject_cast<MediaSource*>(*m_factory->m_mediaFromDB.begin())->id(), (qint64)3);
+}
+
 MediaSource* tst_MediaObjectFactory::wait_for_media()
 {
     if (m_spyMediaObjectCreated->isEmpty())
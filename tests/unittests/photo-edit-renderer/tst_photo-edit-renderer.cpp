@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QImage>
+#include <QString>
+#include <QTemporaryDir>
+
+#include "photo-edit-renderer.h"
+#include "photo-edit-state.h"
+
+class tst_PhotoEditRenderer : public QObject
+{
+  Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void state_crop_string();
+    void state_is_original();
+    void render_crop_rotate();
+    void render_max_size();
+    void preview_cache();
+
+private:
+    QTemporaryDir *m_tmpDir;
+    QString m_photo;
+};
+
+void tst_PhotoEditRenderer::init()
+{
+    m_tmpDir = new QTemporaryDir();
+
+    // Left half red, right half blue
+    QImage image(400, 200, QImage::Format_RGB32);
+    image.fill(QColor(Qt::red));
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 200; x < image.width(); ++x)
+            image.setPixel(x, y, QColor(Qt::blue).rgb());
+
+    m_photo = m_tmpDir->path() + "/photo.png";
+    image.save(m_photo, "PNG");
+
+    PhotoEditRenderer::setPreviewDirectory(m_tmpDir->path() + "/edits");
+}
+
+void tst_PhotoEditRenderer::cleanup()
+{
+    PhotoEditRenderer::setPreviewDirectory(QString());
+    delete m_tmpDir;
+}
+
+void tst_PhotoEditRenderer::state_crop_string()
+{
+    PhotoEditState state;
+    QCOMPARE(state.cropRectangleToString(), QString());
+
+    state.cropRectangle = QRect(10, 20, 30, 40);
+    QCOMPARE(state.cropRectangleToString(), QString("10,20,30,40"));
+
+    PhotoEditState parsed;
+    parsed.setCropRectangleFromString(state.cropRectangleToString());
+    QCOMPARE(parsed.cropRectangle, state.cropRectangle);
+
+    parsed.setCropRectangleFromString("garbage");
+    QVERIFY(parsed.cropRectangle.isNull());
+}
+
+void tst_PhotoEditRenderer::state_is_original()
+{
+    PhotoEditState state;
+    QVERIFY(state.isOriginal());
+
+    state.brightness = 1.5;
+    QVERIFY(!state.isOriginal());
+    QVERIFY(state != PhotoEditState());
+
+    state.brightness = 1.0;
+    QVERIFY(state.isOriginal());
+    QVERIFY(state == PhotoEditState());
+}
+
+void tst_PhotoEditRenderer::render_crop_rotate()
+{
+    PhotoEditState state;
+    state.cropRectangle = QRect(200, 0, 200, 100);
+    state.orientation = RIGHT_TOP_ORIGIN;
+
+    QImage image = PhotoEditRenderer::render(m_photo, TOP_LEFT_ORIGIN, state, QSize());
+    QCOMPARE(image.size(), QSize(100, 200));
+    QCOMPARE(QColor(image.pixel(50, 100)), QColor(Qt::blue));
+}
+
+void tst_PhotoEditRenderer::render_max_size()
+{
+    PhotoEditState state;
+    state.orientation = RIGHT_TOP_ORIGIN;
+
+    QImage image = PhotoEditRenderer::render(m_photo, TOP_LEFT_ORIGIN, state, QSize(100, 100));
+    QCOMPARE(image.size(), QSize(50, 100));
+}
+
+void tst_PhotoEditRenderer::preview_cache()
+{
+    PhotoEditState state;
+    state.cropRectangle = QRect(0, 0, 200, 200);
+
+    QString preview = PhotoEditRenderer::preview(7, m_photo, TOP_LEFT_ORIGIN,
+                                                 state, QSize(100, 100));
+    QVERIFY(QFile::exists(preview));
+    QCOMPARE(QImage(preview).size(), QSize(100, 100));
+
+    // Same edits, same preview
+    QCOMPARE(PhotoEditRenderer::preview(7, m_photo, TOP_LEFT_ORIGIN, state, QSize(100, 100)),
+             preview);
+
+    // A new edit replaces the old preview
+    state.isEnhanced = true;
+    QString enhanced = PhotoEditRenderer::preview(7, m_photo, TOP_LEFT_ORIGIN,
+                                                  state, QSize(100, 100));
+    QVERIFY(enhanced != preview);
+    QVERIFY(QFile::exists(enhanced));
+    QVERIFY(!QFile::exists(preview));
+
+    PhotoEditRenderer::removePreviews(7);
+    QVERIFY(!QFile::exists(enhanced));
+}
+
+QTEST_MAIN(tst_PhotoEditRenderer);
+
+#include "tst_photo-edit-renderer.moc"
@@ -57,6 +57,18 @@ void AlbumTable::detachFromAlbum(qint64 albumId, qint64 mediaId)
     Q_UNUSED(mediaId);
 }
 
+void AlbumTable::attachManyToAlbum(qint64 albumId, const QList<qint64>& mediaIds)
+{
+    Q_UNUSED(albumId);
+    Q_UNUSED(mediaIds);
+}
+
+void AlbumTable::detachManyFromAlbum(qint64 albumId, const QList<qint64>& mediaIds)
+{
+    Q_UNUSED(albumId);
+    Q_UNUSED(mediaIds);
+}
+
 void AlbumTable::mediaForAlbum(qint64 albumId, QList<qint64>* list) const
 {
     Q_UNUSED(albumId);
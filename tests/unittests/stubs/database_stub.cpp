@@ -29,10 +29,13 @@ Database::Database(Resource *resource, QObject* parent) :
     QObject(parent),
     m_databaseDirectory(resource->databaseDirectory()),
     m_sqlSchemaDirectory(resource->getRcUrl("sql").path()),
-    m_db(0)
+    m_db(0),
+    m_profiler(0)
 {
     m_albumTable = new AlbumTable(this, this);
     m_mediaTable = new MediaTable(this, resource, this);
+    m_photoEditTable = 0;
+    m_searchTable = 0;
 }
 
 Database::~Database()
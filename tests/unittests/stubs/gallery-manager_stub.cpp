@@ -44,6 +44,9 @@ GalleryManager::GalleryManager(bool desktopMode, const QString& picturesDir)
       m_albumCollection(0),
       m_eventCollection(0),
       m_monitor(0),
+      m_prefetcher(0),
+      m_feedSliceSize(0),
+      m_monitorWhenFed(false),
       m_mediaLibrary(0)
 {
     Q_UNUSED(picturesDir);
@@ -105,11 +108,16 @@ void GalleryManager::onMediaObjectCreated(MediaSource *mediaObject)
     Q_UNUSED(mediaObject);
 }
 
+void GalleryManager::onMediaFromDBChunkLoaded(QList<DataObject *> mediaChunk)
+{
+    Q_UNUSED(mediaChunk);
+}
+
 void GalleryManager::onMediaFromDBLoaded(QSet<DataObject *> mediaFromDB)
 {
     Q_UNUSED(mediaFromDB);
 }
 
-void GalleryManager::onObjectsReadyToAdd()
+void GalleryManager::onFeedMediaCollection()
 {
 }
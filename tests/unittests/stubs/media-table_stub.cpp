@@ -110,8 +110,9 @@ void MediaTable::setMediaSize(qint64 mediaId, const QSize& size)
 {
 }
 
-void MediaTable::emitAllRows()
+MediaRowCursor* MediaTable::allRows()
 {
+    return new MediaRowCursor(m_db, 0);
 }
 
 void MediaTable::getRow(qint64 mediaId, QSize& size, Orientation& 
@@ -126,3 +127,18 @@ void MediaTable::getRow(qint64 mediaId, QSize& size, Orientation&
         }
     }
 }
+
+MediaRowCursor::MediaRowCursor(Database* db, QSqlQuery* query)
+    : m_db(db),
+      m_query(query)
+{
+}
+
+MediaRowCursor::~MediaRowCursor()
+{
+}
+
+int MediaRowCursor::fetch(MediaRow* rows, int count)
+{
+    return 0;
+}
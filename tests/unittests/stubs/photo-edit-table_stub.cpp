@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2014 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "photo-edit-table.h"
+#include "database.h"
+
+PhotoEditTable::PhotoEditTable(Database* db, QObject* parent)
+    : QObject(parent),
+      m_db(db)
+{
+}
+
+PhotoEditState PhotoEditTable::currentState(qint64 mediaId) const
+{
+    Q_UNUSED(mediaId);
+    return PhotoEditState();
+}
+
+int PhotoEditTable::depth(qint64 mediaId) const
+{
+    Q_UNUSED(mediaId);
+    return 0;
+}
+
+void PhotoEditTable::push(qint64 mediaId, const PhotoEditState& state)
+{
+    Q_UNUSED(mediaId);
+    Q_UNUSED(state);
+}
+
+bool PhotoEditTable::pop(qint64 mediaId)
+{
+    Q_UNUSED(mediaId);
+    return false;
+}
+
+void PhotoEditTable::clear(qint64 mediaId)
+{
+    Q_UNUSED(mediaId);
+}
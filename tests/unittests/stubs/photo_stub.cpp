@@ -38,7 +38,9 @@ QFileInfo photoDummyFileInfo;
 Photo::Photo(const QFileInfo& file)
     : MediaSource(file),
       m_originalSize(),
-      m_originalOrientation(TOP_LEFT_ORIGIN)
+      m_originalOrientation(TOP_LEFT_ORIGIN),
+      m_photoEditTable(0),
+      m_editStateLoaded(false)
 {
     photoDummyFileInfo = file;
 }
@@ -70,3 +72,47 @@ void Photo::setOriginalOrientation(Orientation orientation)
 {
     m_originalOrientation = orientation;
 }
+
+bool Photo::isEdited() const
+{
+    return false;
+}
+
+void Photo::rotate(bool left)
+{
+    Q_UNUSED(left);
+}
+
+void Photo::crop(const QRect& rect)
+{
+    Q_UNUSED(rect);
+}
+
+void Photo::autoEnhance()
+{
+}
+
+void Photo::setColorBalance(qreal brightness, qreal contrast,
+                            qreal saturation, qreal hue)
+{
+    Q_UNUSED(brightness);
+    Q_UNUSED(contrast);
+    Q_UNUSED(saturation);
+    Q_UNUSED(hue);
+}
+
+bool Photo::undoEdit()
+{
+    return false;
+}
+
+void Photo::revertToOriginal()
+{
+}
+
+QUrl Photo::editPreview(int width, int height)
+{
+    Q_UNUSED(width);
+    Q_UNUSED(height);
+    return path();
+}